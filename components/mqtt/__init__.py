@@ -26,11 +26,14 @@ from esphome.const import (
     CONF_DISCOVERY_PREFIX,
     CONF_DISCOVERY_RETAIN,
     CONF_DISCOVERY_UNIQUE_ID_GENERATOR,
+    CONF_ENABLE_IPV6,
     CONF_ENABLE_ON_BOOT,
     CONF_ID,
+    CONF_INTERVAL,
     CONF_KEEPALIVE,
     CONF_LEVEL,
     CONF_LOG_TOPIC,
+    CONF_MQTT_ID,
     CONF_ON_CONNECT,
     CONF_ON_DISCONNECT,
     CONF_ON_JSON_MESSAGE,
@@ -62,7 +65,8 @@ from esphome.const import (
     PLATFORM_RTL87XX,
     PlatformFramework,
 )
-from esphome.core import CORE, CoroPriority, coroutine_with_priority
+from esphome.core import CORE, CoroPriority, Lambda, coroutine_with_priority
+import esphome.final_validate as fv
 from esphome.types import ConfigType
 
 DEPENDENCIES = ["network"]
@@ -77,6 +81,49 @@ def AUTO_LOAD():
 CONF_DISCOVER_IP = "discover_ip"
 CONF_IDF_SEND_ASYNC = "idf_send_async"
 CONF_WAIT_FOR_CONNECTION = "wait_for_connection"
+CONF_JSON_STATE_PAYLOAD = "json_state_payload"
+CONF_SENSOR_BATCH = "sensor_batch"
+CONF_BATCH_SIZE = "batch_size"
+CONF_FLUSH_INTERVAL = "flush_interval"
+CONF_COMPRESSION = "compression"
+CONF_TOPICS = "topics"
+CONF_WINDOW_BITS = "window_bits"
+CONF_LOOKAHEAD_BITS = "lookahead_bits"
+CONF_MIN_SIZE = "min_size"
+CONF_MAX_SIZE = "max_size"
+CONF_TOPIC_SUFFIX = "topic_suffix"
+CONF_PAYLOAD_FORMAT = "payload_format"
+CONF_BUFFER_SIZE = "buffer_size"
+CONF_ROUTES = "routes"
+CONF_TAG = "tag"
+CONF_RESEND_BUDGET = "resend_budget"
+CONF_SKIP_UNCHANGED = "skip_unchanged"
+CONF_DISCOVERY_MODE = "discovery_mode"
+CONF_DISCOVERY_JITTER = "discovery_jitter"
+CONF_REDISCOVER_ON_HA_BIRTH = "rediscover_on_ha_birth"
+CONF_RECONNECT_BACKOFF = "reconnect_backoff"
+CONF_INITIAL = "initial"
+CONF_MULTIPLIER = "multiplier"
+CONF_MAX = "max"
+CONF_JITTER = "jitter"
+CONF_DNS_CACHE_TTL = "dns_cache_ttl"
+CONF_CONNECT_TIMEOUT = "connect_timeout"
+CONF_FAILOVER = "failover"
+CONF_BROKERS = "brokers"
+CONF_ATTEMPTS = "attempts"
+CONF_FAILBACK_INTERVAL = "failback_interval"
+CONF_BURST = "burst"
+CONF_ADAPTIVE_KEEPALIVE = "adaptive_keepalive"
+CONF_MIN = "min"
+CONF_FAMILY_FALLBACK_TIMEOUT = "family_fallback_timeout"
+CONF_TELEMETRY = "telemetry"
+CONF_LATENCY_PROBE = "latency_probe"
+CONF_ON_BURST_COMPLETE = "on_burst_complete"
+
+PAYLOAD_FORMATS = ["json", "msgpack"]
+
+# Entity domains that support publishing all state as one JSON document on the state topic
+JSON_STATE_DOMAINS = ["climate", "fan", "valve"]
 
 # Max lengths for stack-based topic building.
 # These values are used in cv.Length() validators below to ensure the C++ code
@@ -86,6 +133,24 @@ TOPIC_PREFIX_MAX_LEN = 64  # Default is device name, typically short
 DISCOVERY_PREFIX_MAX_LEN = 64  # Default is "homeassistant" (13 chars)
 
 
+def validate_log_tag_pattern(value):
+    value = cv.string_strict(value)
+    if not value or "*" in value[:-1]:
+        raise cv.Invalid(
+            "Tag pattern must be a tag, or a tag prefix followed by a single trailing '*'"
+        )
+    return value
+
+
+LOG_ROUTE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_TAG): validate_log_tag_pattern,
+        cv.Required(CONF_LEVEL): logger.is_log_level,
+        cv.Optional(CONF_TOPIC): cv.publish_topic,
+    }
+)
+
+
 def validate_message_just_topic(value):
     value = cv.publish_topic(value)
     return MQTT_MESSAGE_BASE({CONF_TOPIC: value})
@@ -132,6 +197,9 @@ MQTTConnectTrigger = mqtt_ns.class_(
 MQTTDisconnectTrigger = mqtt_ns.class_(
     "MQTTDisconnectTrigger", automation.Trigger.template(MQTTClientDisconnectReason)
 )
+MQTTBurstCompleteTrigger = mqtt_ns.class_(
+    "MQTTBurstCompleteTrigger", automation.Trigger.template(cg.uint32)
+)
 MQTTComponent = mqtt_ns.class_("MQTTComponent", cg.Component)
 MQTTConnectedCondition = mqtt_ns.class_("MQTTConnectedCondition", Condition)
 
@@ -171,6 +239,90 @@ MQTT_DISCOVERY_OBJECT_ID_GENERATOR_OPTIONS = {
 }
 
 
+def validate_compression(value):
+    if value[CONF_LOOKAHEAD_BITS] >= value[CONF_WINDOW_BITS]:
+        raise cv.Invalid(
+            f"{CONF_LOOKAHEAD_BITS} must be smaller than {CONF_WINDOW_BITS}",
+            path=[CONF_LOOKAHEAD_BITS],
+        )
+    if value[CONF_MAX_SIZE] < value[CONF_MIN_SIZE]:
+        raise cv.Invalid(
+            f"{CONF_MAX_SIZE} must not be smaller than {CONF_MIN_SIZE}",
+            path=[CONF_MAX_SIZE],
+        )
+    return value
+
+
+def validate_reconnect_backoff(value):
+    if value[CONF_MAX] < value[CONF_INITIAL]:
+        raise cv.Invalid(
+            f"{CONF_MAX} must not be smaller than {CONF_INITIAL}", path=[CONF_MAX]
+        )
+    return value
+
+
+def validate_adaptive_keepalive(value):
+    if value[CONF_MAX] < value[CONF_MIN]:
+        raise cv.Invalid(
+            f"{CONF_MAX} must not be smaller than {CONF_MIN}", path=[CONF_MAX]
+        )
+    if value[CONF_MAX].total_seconds > 65535:
+        raise cv.Invalid("The MQTT keep alive is at most 65535s", path=[CONF_MAX])
+    return value
+
+
+def validate_connect_by_ip(value):
+    if CONF_CERTIFICATE_AUTHORITY not in value:
+        return value
+    for key in (CONF_DNS_CACHE_TTL, CONF_FAMILY_FALLBACK_TIMEOUT):
+        if key in value:
+            raise cv.Invalid(
+                f"{key} connects by IP address, which breaks the TLS hostname check",
+                path=[key],
+            )
+    return value
+
+
+def _final_validate(config):
+    if CONF_FAMILY_FALLBACK_TIMEOUT not in config:
+        return
+    network_config = fv.full_config.get().get("network", {})
+    if not network_config.get(CONF_ENABLE_IPV6, False):
+        raise cv.Invalid(
+            f"{CONF_FAMILY_FALLBACK_TIMEOUT} requires {CONF_ENABLE_IPV6}: true in the "
+            "network component",
+            path=[CONF_FAMILY_FALLBACK_TIMEOUT],
+        )
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
+def validate_burst(value):
+    if value[CONF_BURST] and value[CONF_SKIP_UNCHANGED] != "PERSIST":
+        raise cv.Invalid(
+            f"{CONF_BURST} requires {CONF_SKIP_UNCHANGED}: PERSIST, discovery and unchanged "
+            "states are only skipped when the hashes survive deep sleep",
+            path=[CONF_BURST],
+        )
+    if CONF_ON_BURST_COMPLETE in value and not value[CONF_BURST]:
+        raise cv.Invalid(
+            f"{CONF_ON_BURST_COMPLETE} requires {CONF_BURST}: true",
+            path=[CONF_ON_BURST_COMPLETE],
+        )
+    return value
+
+
+def validate_skip_unchanged(value):
+    if value.get(CONF_SKIP_UNCHANGED, False) and value[CONF_CLEAN_SESSION]:
+        raise cv.Invalid(
+            f"{CONF_SKIP_UNCHANGED} requires {CONF_CLEAN_SESSION}: false, the broker's session flag "
+            "is what tells whether its retained messages can be trusted",
+            path=[CONF_SKIP_UNCHANGED],
+        )
+    return value
+
+
 def validate_config(value):
     # Populate default fields
     out = value.copy()
@@ -266,6 +418,33 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(CONF_DISCOVERY_OBJECT_ID_GENERATOR, default="none"): cv.enum(
                 MQTT_DISCOVERY_OBJECT_ID_GENERATOR_OPTIONS
             ),
+            cv.Optional(
+                CONF_DISCOVERY_JITTER, default="0s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_REDISCOVER_ON_HA_BIRTH, default=False): cv.boolean,
+            cv.Optional(CONF_DISCOVERY_MODE, default="entity"): cv.one_of(
+                "entity", "device", lower=True
+            ),
+            cv.Optional(CONF_SKIP_UNCHANGED, default=False): cv.Any(
+                cv.boolean, cv.one_of("PERSIST", upper=True)
+            ),
+            cv.Optional(CONF_TELEMETRY, default=False): cv.boolean,
+            cv.Optional(CONF_LATENCY_PROBE): cv.Schema(
+                {
+                    cv.Optional(
+                        CONF_INTERVAL, default="60s"
+                    ): cv.positive_time_period_milliseconds,
+                    cv.Optional(CONF_QOS, default=0): cv.mqtt_qos,
+                }
+            ),
+            cv.Optional(CONF_BURST, default=False): cv.boolean,
+            cv.Optional(CONF_ON_BURST_COMPLETE): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        MQTTBurstCompleteTrigger
+                    ),
+                }
+            ),
             cv.Optional(CONF_USE_ABBREVIATIONS, default=True): cv.boolean,
             cv.Optional(CONF_BIRTH_MESSAGE): MQTT_MESSAGE_SCHEMA,
             cv.Optional(CONF_WILL_MESSAGE): MQTT_MESSAGE_SCHEMA,
@@ -278,14 +457,83 @@ CONFIG_SCHEMA = cv.All(
                 MQTT_MESSAGE_BASE.extend(
                     {
                         cv.Optional(CONF_LEVEL): logger.is_log_level,
+                        cv.Optional(CONF_BUFFER_SIZE): cv.int_range(
+                            min=128, max=16384
+                        ),
+                        cv.Optional(
+                            CONF_FLUSH_INTERVAL, default="250ms"
+                        ): cv.positive_time_period_milliseconds,
+                        cv.Optional(CONF_ROUTES): cv.ensure_list(LOG_ROUTE_SCHEMA),
                     }
                 ),
                 validate_message_just_topic,
             ),
             cv.Optional(CONF_KEEPALIVE, default="15s"): cv.positive_time_period_seconds,
+            cv.Optional(CONF_ADAPTIVE_KEEPALIVE): cv.All(
+                cv.Schema(
+                    {
+                        cv.Optional(
+                            CONF_MIN, default="15s"
+                        ): cv.positive_time_period_seconds,
+                        cv.Optional(
+                            CONF_MAX, default="5min"
+                        ): cv.positive_time_period_seconds,
+                    }
+                ),
+                validate_adaptive_keepalive,
+            ),
             cv.Optional(
                 CONF_REBOOT_TIMEOUT, default="15min"
             ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_DNS_CACHE_TTL): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_FAMILY_FALLBACK_TIMEOUT
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_CONNECT_TIMEOUT, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_FAILOVER): cv.Schema(
+                {
+                    cv.Required(CONF_BROKERS): cv.All(
+                        cv.ensure_list(
+                            cv.Schema(
+                                {
+                                    cv.Required(CONF_BROKER): cv.string_strict,
+                                    cv.Optional(CONF_PORT, default=1883): cv.port,
+                                    cv.Optional(CONF_USERNAME, default=""): cv.string,
+                                    cv.Optional(
+                                        CONF_PASSWORD, default=""
+                                    ): cv.sensitive(),
+                                }
+                            )
+                        ),
+                        cv.Length(min=1, max=254),
+                    ),
+                    cv.Optional(CONF_ATTEMPTS, default=3): cv.int_range(
+                        min=1, max=255
+                    ),
+                    cv.Optional(
+                        CONF_FAILBACK_INTERVAL, default="10min"
+                    ): cv.positive_time_period_milliseconds,
+                }
+            ),
+            cv.Optional(CONF_RECONNECT_BACKOFF): cv.All(
+                cv.Schema(
+                    {
+                        cv.Optional(
+                            CONF_INITIAL, default="5s"
+                        ): cv.positive_time_period_milliseconds,
+                        cv.Optional(CONF_MULTIPLIER, default=2.0): cv.float_range(
+                            min=1.0
+                        ),
+                        cv.Optional(
+                            CONF_MAX, default="5min"
+                        ): cv.positive_time_period_milliseconds,
+                        cv.Optional(CONF_JITTER, default=True): cv.boolean,
+                    }
+                ),
+                validate_reconnect_backoff,
+            ),
             cv.Optional(CONF_ON_CONNECT): automation.validate_automation(
                 {
                     cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(MQTTConnectTrigger),
@@ -317,9 +565,62 @@ CONFIG_SCHEMA = cv.All(
             ),
             cv.Optional(CONF_PUBLISH_NAN_AS_NONE, default=False): cv.boolean,
             cv.Optional(CONF_WAIT_FOR_CONNECTION, default=False): cv.boolean,
+            cv.Optional(
+                CONF_RESEND_BUDGET, default="5ms"
+            ): cv.positive_time_period_microseconds,
+            cv.Optional(CONF_PAYLOAD_FORMAT, default="json"): cv.one_of(
+                *PAYLOAD_FORMATS, lower=True
+            ),
+            cv.Optional(CONF_JSON_STATE_PAYLOAD): cv.All(
+                cv.ensure_list(cv.one_of(*JSON_STATE_DOMAINS, lower=True)),
+                cv.Length(min=1),
+            ),
+            cv.Optional(CONF_SENSOR_BATCH): cv.ensure_list(
+                cv.Schema(
+                    {
+                        cv.Required(CONF_MQTT_ID): cv.use_id(MQTTSensorComponent),
+                        cv.Optional(CONF_BATCH_SIZE, default=50): cv.int_range(
+                            min=1, max=1024
+                        ),
+                        cv.Optional(
+                            CONF_FLUSH_INTERVAL, default="1s"
+                        ): cv.positive_time_period_milliseconds,
+                    }
+                )
+            ),
+            cv.Optional(CONF_COMPRESSION): cv.All(
+                cv.Schema(
+                    {
+                        cv.Required(CONF_TOPICS): cv.All(
+                            cv.ensure_list(cv.subscribe_topic), cv.Length(min=1)
+                        ),
+                        # The encoder runs inside publish() and scans the whole window per
+                        # byte: window and payload size bound the time it blocks the loop
+                        cv.Optional(CONF_WINDOW_BITS, default=8): cv.int_range(
+                            min=4, max=8
+                        ),
+                        cv.Optional(CONF_LOOKAHEAD_BITS, default=4): cv.int_range(
+                            min=3, max=7
+                        ),
+                        cv.Optional(CONF_MIN_SIZE, default=128): cv.int_range(
+                            min=16
+                        ),
+                        cv.Optional(CONF_MAX_SIZE, default=1024): cv.int_range(
+                            min=16, max=2048
+                        ),
+                        cv.Optional(CONF_TOPIC_SUFFIX, default="/hs"): cv.All(
+                            cv.string_strict, cv.Length(min=1)
+                        ),
+                    }
+                ),
+                validate_compression,
+            ),
         }
     ),
     validate_config,
+    validate_skip_unchanged,
+    validate_burst,
+    validate_connect_by_ip,
     cv.only_on(
         [
             PLATFORM_BK72XX,
@@ -410,6 +711,33 @@ async def to_code(config):
             )
         )
 
+    cg.add(var.set_discovery_jitter(config[CONF_DISCOVERY_JITTER]))
+    cg.add(var.set_rediscover_on_ha_birth(config[CONF_REDISCOVER_ON_HA_BIRTH]))
+
+    if config[CONF_DISCOVERY_MODE] == "device":
+        # One <prefix>/device/<node>/config payload lists every entity, see
+        # https://www.home-assistant.io/integrations/mqtt/#device-discovery-payload
+        cg.add_define("USE_MQTT_DEVICE_DISCOVERY")
+
+    if skip_unchanged := config[CONF_SKIP_UNCHANGED]:
+        cg.add_define("USE_MQTT_SKIP_UNCHANGED")
+        cg.add(var.set_skip_unchanged(skip_unchanged == "PERSIST"))
+
+    if config[CONF_TELEMETRY]:
+        cg.add_define("USE_MQTT_TELEMETRY")
+
+    if probe_config := config.get(CONF_LATENCY_PROBE):
+        cg.add_define("USE_MQTT_LATENCY_PROBE")
+        cg.add(
+            var.set_latency_probe(probe_config[CONF_INTERVAL], probe_config[CONF_QOS])
+        )
+
+    if config[CONF_BURST]:
+        cg.add_define("USE_MQTT_BURST")
+    for conf in config.get(CONF_ON_BURST_COMPLETE, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(cg.uint32, "elapsed")], conf)
+
     cg.add(var.set_topic_prefix(config[CONF_TOPIC_PREFIX], CORE.name))
 
     if config[CONF_USE_ABBREVIATIONS]:
@@ -442,10 +770,73 @@ async def to_code(config):
         if CONF_LEVEL in log_topic:
             cg.add(var.set_log_level(logger.LOG_LEVELS[log_topic[CONF_LEVEL]]))
 
+        if routes := log_topic.get(CONF_ROUTES):
+            cg.add_define("USE_MQTT_LOG_ROUTES")
+            for route in routes:
+                args = [route[CONF_TAG], logger.LOG_LEVELS[route[CONF_LEVEL]]]
+                if CONF_TOPIC in route:
+                    args.append(route[CONF_TOPIC])
+                cg.add(var.add_log_route(*args))
+
+        if CONF_BUFFER_SIZE in log_topic:
+            cg.add_define("USE_MQTT_LOG_BUFFER")
+            cg.add(
+                var.set_log_buffer(
+                    log_topic[CONF_BUFFER_SIZE], log_topic[CONF_FLUSH_INTERVAL]
+                )
+            )
+
     cg.add(var.set_keep_alive(config[CONF_KEEPALIVE]))
+    if keepalive_config := config.get(CONF_ADAPTIVE_KEEPALIVE):
+        cg.add_define("USE_MQTT_ADAPTIVE_KEEPALIVE")
+        cg.add(
+            var.set_adaptive_keep_alive(
+                keepalive_config[CONF_MIN], keepalive_config[CONF_MAX]
+            )
+        )
 
     cg.add(var.set_reboot_timeout(config[CONF_REBOOT_TIMEOUT]))
 
+    cg.add(var.set_connect_timeout(config[CONF_CONNECT_TIMEOUT]))
+
+    if failover_config := config.get(CONF_FAILOVER):
+        cg.add_define("USE_MQTT_FAILOVER")
+        for broker in failover_config[CONF_BROKERS]:
+            cg.add(
+                var.add_failover_broker(
+                    broker[CONF_BROKER],
+                    broker[CONF_PORT],
+                    broker[CONF_USERNAME],
+                    broker[CONF_PASSWORD],
+                )
+            )
+        cg.add(
+            var.set_failover(
+                failover_config[CONF_ATTEMPTS],
+                failover_config[CONF_FAILBACK_INTERVAL],
+            )
+        )
+
+    if CONF_FAMILY_FALLBACK_TIMEOUT in config:
+        cg.add_define("USE_MQTT_DUAL_STACK")
+        cg.add(
+            var.set_family_fallback_timeout(config[CONF_FAMILY_FALLBACK_TIMEOUT])
+        )
+
+    if CONF_DNS_CACHE_TTL in config:
+        cg.add_define("USE_MQTT_DNS_CACHE")
+        cg.add(var.set_dns_cache_ttl(config[CONF_DNS_CACHE_TTL]))
+
+    if backoff_config := config.get(CONF_RECONNECT_BACKOFF):
+        cg.add(
+            var.set_reconnect_backoff(
+                backoff_config[CONF_INITIAL],
+                backoff_config[CONF_MULTIPLIER],
+                backoff_config[CONF_MAX],
+                backoff_config[CONF_JITTER],
+            )
+        )
+
     # esp-idf only
     if CONF_CERTIFICATE_AUTHORITY in config:
         cg.add(var.set_ca_certificate(config[CONF_CERTIFICATE_AUTHORITY]))
@@ -490,6 +881,52 @@ async def to_code(config):
 
     cg.add(var.set_wait_for_connection(config[CONF_WAIT_FOR_CONNECTION]))
 
+    cg.add(var.set_resend_budget(config[CONF_RESEND_BUDGET]))
+
+    if config[CONF_PAYLOAD_FORMAT] == "msgpack":
+        # Custom devices, publish_json and entities hidden from discovery use MessagePack,
+        # everything Home Assistant reads stays JSON
+        cg.add_define("USE_MQTT_MSGPACK")
+
+    for domain in config.get(CONF_JSON_STATE_PAYLOAD, []):
+        cg.add_define(f"USE_MQTT_{domain.upper()}_JSON")
+        # JSON mode is off by default like cover's, turn it on for every entity of the domain
+        for entity_conf in CORE.config.get(domain, []):
+            if CONF_MQTT_ID in entity_conf:
+                mqtt_entity = await cg.get_variable(entity_conf[CONF_MQTT_ID])
+                cg.add(mqtt_entity.set_use_json_format(True))
+
+    if compression := config.get(CONF_COMPRESSION):
+        cg.add_define("USE_MQTT_COMPRESSION")
+        cg.add(
+            var.set_compression(
+                compression[CONF_WINDOW_BITS],
+                compression[CONF_LOOKAHEAD_BITS],
+                compression[CONF_MIN_SIZE],
+                compression[CONF_MAX_SIZE],
+                compression[CONF_TOPIC_SUFFIX],
+            )
+        )
+        for topic in compression[CONF_TOPICS]:
+            cg.add(var.add_compressed_topic(topic))
+
+    if sensor_batch := config.get(CONF_SENSOR_BATCH):
+        cg.add_define("USE_MQTT_SENSOR_BATCH")
+        for conf in sensor_batch:
+            mqtt_sensor = await cg.get_variable(conf[CONF_MQTT_ID])
+            cg.add(
+                mqtt_sensor.set_batch(conf[CONF_BATCH_SIZE], conf[CONF_FLUSH_INTERVAL])
+            )
+
+
+async def _set_publish_topic(var, topic, args):
+    # Static topics are emitted as string literals so play() does not build a std::string
+    if isinstance(topic, Lambda):
+        template_ = await cg.templatable(topic, args, cg.std_string)
+        cg.add(var.set_topic(template_))
+    else:
+        cg.add(var.set_topic_static(topic))
+
 
 MQTT_PUBLISH_ACTION_SCHEMA = cv.Schema(
     {
@@ -508,11 +945,14 @@ MQTT_PUBLISH_ACTION_SCHEMA = cv.Schema(
 async def mqtt_publish_action_to_code(config, action_id, template_arg, args):
     paren = await cg.get_variable(config[CONF_ID])
     var = cg.new_Pvariable(action_id, template_arg, paren)
-    template_ = await cg.templatable(config[CONF_TOPIC], args, cg.std_string)
-    cg.add(var.set_topic(template_))
+    await _set_publish_topic(var, config[CONF_TOPIC], args)
 
-    template_ = await cg.templatable(config[CONF_PAYLOAD], args, cg.std_string)
-    cg.add(var.set_payload(template_))
+    payload = config[CONF_PAYLOAD]
+    if isinstance(payload, Lambda):
+        template_ = await cg.templatable(payload, args, cg.std_string)
+        cg.add(var.set_payload(template_))
+    else:
+        cg.add(var.set_payload_static(payload, len(payload.encode("utf-8"))))
     template_ = await cg.templatable(config[CONF_QOS], args, cg.uint8)
     cg.add(var.set_qos(template_))
     template_ = await cg.templatable(config[CONF_RETAIN], args, cg.bool_)
@@ -540,8 +980,7 @@ MQTT_PUBLISH_JSON_ACTION_SCHEMA = cv.Schema(
 async def mqtt_publish_json_action_to_code(config, action_id, template_arg, args):
     paren = await cg.get_variable(config[CONF_ID])
     var = cg.new_Pvariable(action_id, template_arg, paren)
-    template_ = await cg.templatable(config[CONF_TOPIC], args, cg.std_string)
-    cg.add(var.set_topic(template_))
+    await _set_publish_topic(var, config[CONF_TOPIC], args)
 
     args_ = args + [(cg.JsonObject, "root")]
     lambda_ = await cg.process_lambda(config[CONF_PAYLOAD], args_, return_type=cg.void)
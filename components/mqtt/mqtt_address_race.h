@@ -0,0 +1,102 @@
+#pragma once
+#include "esphome/core/defines.h"
+#ifdef USE_MQTT_DUAL_STACK
+#include <cstdint>
+
+namespace esphome::mqtt {
+
+/** Staggered race between the IPv6 and the IPv4 address of the broker (RFC 8305 "Happy Eyeballs").
+ *
+ * Both families are resolved in parallel. The preferred family is probed as soon as its address is known, the
+ * other one once the stagger has passed since the race started, or right away when the preferred family failed.
+ * The first family whose TCP handshake completes wins. The class only holds the decisions, the caller runs
+ * the lookups and handshakes and reports their results, which keeps it free of lwIP and testable on a host.
+ */
+class MQTTAddressRace {
+ public:
+  enum Family : uint8_t {
+    FAMILY_IPV6 = 0,
+    FAMILY_IPV4 = 1,
+  };
+  enum Action : uint8_t {
+    ACTION_NONE,
+    ACTION_PROBE_IPV6,  ///< Start the handshake with the IPv6 address
+    ACTION_PROBE_IPV4,  ///< Start the handshake with the IPv4 address
+    ACTION_CONNECT,     ///< winner() completed its handshake, connect to it
+    ACTION_FAILED,      ///< Neither family can be reached
+  };
+
+  void start(uint32_t now, bool ipv6_first, uint32_t stagger) {
+    this->started_at_ = now;
+    this->stagger_ = stagger;
+    this->preferred_ = ipv6_first ? FAMILY_IPV6 : FAMILY_IPV4;
+    this->states_[FAMILY_IPV6] = STATE_RESOLVING;
+    this->states_[FAMILY_IPV4] = STATE_RESOLVING;
+    this->resolved_any_ = false;
+    this->done_ = false;
+  }
+  /// Result of the address lookup of a family.
+  void resolved(Family family, bool success) {
+    if (this->states_[family] != STATE_RESOLVING)
+      return;
+    this->states_[family] = success ? STATE_RESOLVED : STATE_FAILED;
+    this->resolved_any_ |= success;
+  }
+  /// Result of the handshake started for an ACTION_PROBE_* of a family.
+  void probed(Family family, bool success) {
+    if (this->states_[family] == STATE_PROBING)
+      this->states_[family] = success ? STATE_CONNECTED : STATE_FAILED;
+  }
+
+  /// Next step for the caller, call until it returns ACTION_NONE. Returns ACTION_NONE once finished.
+  Action poll(uint32_t now) {
+    if (this->done_)
+      return ACTION_NONE;
+    const Family other = this->other_();
+    if (this->states_[this->preferred_] == STATE_CONNECTED || this->states_[other] == STATE_CONNECTED) {
+      this->winner_ = this->states_[this->preferred_] == STATE_CONNECTED ? this->preferred_ : other;
+      this->done_ = true;
+      return ACTION_CONNECT;
+    }
+    if (this->states_[FAMILY_IPV6] == STATE_FAILED && this->states_[FAMILY_IPV4] == STATE_FAILED) {
+      this->done_ = true;
+      return ACTION_FAILED;
+    }
+    if (this->states_[this->preferred_] == STATE_RESOLVED)
+      return this->probe_(this->preferred_);
+    if (this->states_[other] == STATE_RESOLVED &&
+        (this->states_[this->preferred_] == STATE_FAILED || now - this->started_at_ >= this->stagger_))
+      return this->probe_(other);
+    return ACTION_NONE;
+  }
+
+  /// Whether a lookup of either family succeeded so far.
+  bool any_resolved() const { return this->resolved_any_; }
+  Family winner() const { return this->winner_; }
+
+ protected:
+  enum State : uint8_t {
+    STATE_FAILED,
+    STATE_RESOLVING,
+    STATE_RESOLVED,
+    STATE_PROBING,
+    STATE_CONNECTED,
+  };
+
+  Family other_() const { return this->preferred_ == FAMILY_IPV6 ? FAMILY_IPV4 : FAMILY_IPV6; }
+  Action probe_(Family family) {
+    this->states_[family] = STATE_PROBING;
+    return family == FAMILY_IPV6 ? ACTION_PROBE_IPV6 : ACTION_PROBE_IPV4;
+  }
+
+  uint32_t started_at_{0};
+  uint32_t stagger_{0};
+  State states_[2]{STATE_FAILED, STATE_FAILED};
+  Family preferred_{FAMILY_IPV6};
+  Family winner_{FAMILY_IPV6};
+  bool resolved_any_{false};
+  bool done_{true};
+};
+
+}  // namespace esphome::mqtt
+#endif
@@ -19,6 +19,9 @@ enum class MQTTClientDisconnectReason : int8_t {
   TLS_BAD_FINGERPRINT = 7,
   DNS_RESOLVE_ERROR = 8
 };
+/// Number of MQTTClientDisconnectReason values, follows the last one.
+static constexpr uint8_t MQTT_DISCONNECT_REASON_COUNT =
+    static_cast<uint8_t>(MQTTClientDisconnectReason::DNS_RESOLVE_ERROR) + 1;
 
 /// internal struct for MQTT messages.
 struct MQTTMessage {
@@ -12,12 +12,16 @@ namespace esphome::mqtt {
 
 static const char *const TAG = "mqtt.idf";
 
-bool MQTTBackendESP32::initialize_() {
+void MQTTBackendESP32::update_config_() {
   mqtt_cfg_.broker.address.hostname = this->host_.c_str();
   mqtt_cfg_.broker.address.port = this->port_;
   mqtt_cfg_.session.keepalive = this->keep_alive_;
   mqtt_cfg_.session.disable_clean_session = !this->clean_session_;
+  // MQTTClientComponent decides when to reconnect (backoff, failover), see connect()
+  mqtt_cfg_.network.disable_auto_reconnect = true;
 
+  mqtt_cfg_.credentials.username = nullptr;
+  mqtt_cfg_.credentials.authentication.password = nullptr;
   if (!this->username_.empty()) {
     mqtt_cfg_.credentials.username = this->username_.c_str();
     if (!this->password_.empty()) {
@@ -51,7 +55,10 @@ bool MQTTBackendESP32::initialize_() {
   } else {
     mqtt_cfg_.broker.address.transport = MQTT_TRANSPORT_OVER_TCP;
   }
+}
 
+bool MQTTBackendESP32::initialize_() {
+  this->update_config_();
   auto *mqtt_client = esp_mqtt_client_init(&mqtt_cfg_);
   if (mqtt_client) {
     handler_.reset(mqtt_client);
@@ -79,6 +86,21 @@ bool MQTTBackendESP32::initialize_() {
   }
 }
 
+void MQTTBackendESP32::connect() {
+  if (!this->is_initalized_) {
+    if (this->initialize_())
+      esp_mqtt_client_start(this->handler_.get());
+    return;
+  }
+  // With auto reconnect disabled the client stays down after a disconnect until it is restarted here
+  esp_mqtt_client_stop(this->handler_.get());
+  // esp-mqtt copies its config, so server, credentials or keep alive set since the last connect (cached or
+  // re-resolved address, failover broker) only take effect once handed over again
+  this->update_config_();
+  esp_mqtt_set_config(this->handler_.get(), &this->mqtt_cfg_);
+  esp_mqtt_client_start(this->handler_.get());
+}
+
 void MQTTBackendESP32::loop() {
   // process new events
   // handle only 1 message per loop iteration
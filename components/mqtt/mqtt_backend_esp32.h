@@ -132,10 +132,9 @@ class MQTTBackendESP32 final : public MQTTBackend {
   void set_clean_session(bool clean_session) final { this->clean_session_ = clean_session; }
 
   void set_credentials(const char *username, const char *password) final {
-    if (username)
-      this->username_ = username;
-    if (password)
-      this->password_ = password;
+    // Cleared when not given, a failover broker may not use the credentials of the previous one
+    this->username_ = username != nullptr ? username : "";
+    this->password_ = password != nullptr ? password : "";
   }
   void set_will(const char *topic, uint8_t qos, bool retain, const char *payload) final {
     if (topic)
@@ -174,13 +173,7 @@ class MQTTBackendESP32 final : public MQTTBackend {
   }
   bool connected() const final { return this->is_connected_; }
 
-  void connect() final {
-    if (!is_initalized_) {
-      if (initialize_()) {
-        esp_mqtt_client_start(handler_.get());
-      }
-    }
-  }
+  void connect() final;
   void disconnect() final {
     if (is_initalized_)
       esp_mqtt_client_disconnect(handler_.get());
@@ -227,6 +220,8 @@ class MQTTBackendESP32 final : public MQTTBackend {
 
  protected:
   bool initialize_();
+  /// Fill mqtt_cfg_ from the current settings.
+  void update_config_();
   void mqtt_event_handler_(const Event &event);
   static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
 
@@ -26,6 +26,9 @@ class MQTTBinarySensorComponent final : public mqtt::MQTTComponent {
   void set_is_status(bool status);
 
   bool send_initial_state() override;
+#ifdef USE_MQTT_BURST
+  bool has_initial_state() const override { return this->binary_sensor_->has_state(); }
+#endif
   bool publish_state(bool state);
 
  protected:
@@ -2,6 +2,9 @@
 
 #ifdef USE_MQTT
 
+#include <algorithm>
+#include <cinttypes>
+#include <strings.h>
 #include <utility>
 #include "esphome/components/network/util.h"
 #include "esphome/core/application.h"
@@ -16,6 +19,10 @@
 #include "lwip/dns.h"
 #include "lwip/err.h"
 #include "mqtt_component.h"
+#include "mqtt_const.h"
+#ifdef USE_MQTT_COMPRESSION
+#include "mqtt_compression.h"
+#endif
 
 #ifdef USE_API
 #include "esphome/components/api/api_server.h"
@@ -28,14 +35,37 @@ namespace esphome::mqtt {
 
 static const char *const TAG = "mqtt";
 
-// Maximum number of MQTT component resends per loop iteration.
-// Limits work to avoid triggering the task watchdog on reconnect.
-static constexpr uint8_t MAX_RESENDS_PER_LOOP = 8;
+// Time after CONNACK before subscriptions and messages go out, the backend needs it to finish setting up
+static constexpr uint32_t MQTT_CONNECT_SETTLE_TIME = 100;
+
+// Wait before the next resend pass after a failed resend, doubled per failure up to the maximum
+static constexpr uint32_t MQTT_RESEND_BACKOFF_MIN = 50;
+static constexpr uint32_t MQTT_RESEND_BACKOFF_MAX = 1000;
+
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+// Keep alive intervals a connection has to stay up before the keep alive is widened
+static constexpr uint32_t MQTT_KEEPALIVE_STABLE_INTERVALS = 10;
+// Consecutive drops that look like an idle timeout on the path before the keep alive is narrowed
+static constexpr uint8_t MQTT_KEEPALIVE_TIMEOUT_DROPS = 2;
+#endif
+
+#if USE_NETWORK_IPV6
+static constexpr uint8_t MQTT_DNS_ADDRTYPE = LWIP_DNS_ADDRTYPE_IPV6_IPV4;
+#else
+static constexpr uint8_t MQTT_DNS_ADDRTYPE = LWIP_DNS_ADDRTYPE_IPV4;
+#endif
+
+#ifdef USE_MQTT_LOG_BUFFER
+// Spare bytes after the log buffer for the "[dropped N lines]" marker
+static constexpr size_t LOG_BUFFER_MARKER_RESERVE = 32;
+#endif
 
 // Disconnect reason strings indexed by MQTTClientDisconnectReason enum (0-8)
 PROGMEM_STRING_TABLE(MQTTDisconnectReasonStrings, "TCP disconnected", "Unacceptable Protocol Version",
                      "Identifier Rejected", "Server Unavailable", "Malformed Credentials", "Not Authorized",
                      "Not Enough Space", "TLS Bad Fingerprint", "DNS Resolve Error", "Unknown");
+static_assert(MQTTDisconnectReasonStrings::LAST_INDEX == MQTT_DISCONNECT_REASON_COUNT,
+              "One string per MQTTClientDisconnectReason, followed by \"Unknown\"");
 
 MQTTClientComponent::MQTTClientComponent() {
   global_mqtt_client = this;
@@ -48,6 +78,9 @@ MQTTClientComponent::MQTTClientComponent() {
 void MQTTClientComponent::setup() {
   this->mqtt_backend_.set_on_message(
       [this](const char *topic, const char *payload, size_t len, size_t index, size_t total) {
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+        this->last_rx_ = millis();
+#endif
         if (index == 0) {
           this->payload_buffer_.clear();
           this->payload_buffer_.reserve(total);
@@ -65,10 +98,54 @@ void MQTTClientComponent::setup() {
   this->mqtt_backend_.set_on_disconnect([this](MQTTClientDisconnectReason reason) {
     if (this->state_ == MQTT_CLIENT_DISABLED)
       return;
-    this->state_ = MQTT_CLIENT_DISCONNECTED;
+#ifdef USE_MQTT_DNS_CACHE
+    if (this->state_ == MQTT_CLIENT_CONNECTING)
+      this->drop_cached_ip_();
+#endif
+#ifdef USE_MQTT_DUAL_STACK
+    // Refused before CONNACK: prefer the other family in the next race
+    if (this->state_ == MQTT_CLIENT_CONNECTING)
+      this->ipv6_first_ = !this->connect_ip_.is_ip6();
+#endif
+    this->set_disconnected_();
     this->disconnect_reason_ = reason;
+#ifdef USE_MQTT_SKIP_UNCHANGED
+    this->session_present_ = false;
+#endif
+#ifdef USE_MQTT_BURST
+    this->inflight_ = 0;
+#endif
+  });
+#ifdef USE_MQTT_BURST
+  this->mqtt_backend_.set_on_publish([this](uint16_t packet_id) {
+    if (this->inflight_ > 0)
+      this->inflight_--;
   });
+  this->subscriptions_pref_ = global_preferences->make_preference<uint32_t>(fnv1_hash("mqtt_subscriptions"));
+  this->subscriptions_pref_.load(&this->subscriptions_hash_);
+#endif
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  // Set once the per-entity topics of an earlier single-component setup were moved to the device payload
+  this->entity_discovery_pref_ = global_preferences->make_preference<bool>(fnv1_hash("mqtt_entity_discovery"));
+  bool entity_discovery_moved = false;
+  if (this->entity_discovery_pref_.load(&entity_discovery_moved) && entity_discovery_moved)
+    this->entity_discovery_step_ = ENTITY_DISCOVERY_DONE;
+#endif
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  this->mqtt_backend_.set_on_connect([this](bool session_present) { this->session_present_ = session_present; });
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  if (this->skip_unchanged_persist_) {
+    this->device_discovery_pref_ = global_preferences->make_preference<uint32_t>(fnv1_hash("mqtt_device_discovery"));
+    this->device_discovery_pref_.load(&this->device_discovery_hash_);
+  }
+#endif
+#endif
 #ifdef USE_LOGGER
+#ifdef USE_MQTT_LOG_BUFFER
+  if (this->is_log_message_enabled() && this->log_buffer_size_ > 0) {
+    this->log_buffer_ = make_unique<char[]>(this->log_buffer_size_ + LOG_BUFFER_MARKER_RESERVE);
+  }
+#endif
   if (this->is_log_message_enabled() && logger::global_logger != nullptr) {
     logger::global_logger->add_log_callback(
         this, [](void *self, uint8_t level, const char *tag, const char *message, size_t message_len) {
@@ -77,10 +154,19 @@ void MQTTClientComponent::setup() {
   }
 #endif
 
+  if (this->discovery_jitter_ > 0) {
+    // Deterministic per node so a fleet answering the same trigger is spread evenly over the window
+    char mac[MAC_ADDRESS_BUFFER_SIZE];
+    get_mac_address_into_buffer(mac);
+    this->jitter_offset_ = fnv1_hash(mac) % this->discovery_jitter_;
+  }
+
+#ifndef USE_MQTT_BURST
+  // A node in burst mode sleeps most of the time and cannot answer fleet-wide triggers anyway
   if (this->is_discovery_ip_enabled()) {
     this->subscribe(
-        "esphome/discover", [this](const std::string &topic, const std::string &payload) { this->send_device_info_(); },
-        2);
+        "esphome/discover",
+        [this](const std::string &topic, const std::string &payload) { this->schedule_device_info_(); }, 2);
 
     // Format topic on stack - subscribe() copies it
     // "esphome/ping/" (13) + name (ESPHOME_DEVICE_NAME_MAX_LEN) + null (1)
@@ -88,14 +174,109 @@ void MQTTClientComponent::setup() {
     char ping_topic[ping_topic_buffer_size];
     buf_append_printf(ping_topic, sizeof(ping_topic), 0, "esphome/ping/%s", App.get_name().c_str());
     this->subscribe(
-        ping_topic, [this](const std::string &topic, const std::string &payload) { this->send_device_info_(); }, 2);
+        ping_topic, [this](const std::string &topic, const std::string &payload) { this->schedule_device_info_(); },
+        2);
   }
 
+  if (this->rediscover_on_ha_birth_ && this->is_discovery_enabled()) {
+    // Home Assistant publishes "online" to <prefix>/status when it (re)starts
+    char status_topic[MQTT_DISCOVERY_PREFIX_MAX_LEN + 8];
+    buf_append_printf(status_topic, sizeof(status_topic), 0, "%s/status", this->discovery_info_.prefix.c_str());
+    this->subscribe(status_topic, [this](const std::string &topic, const std::string &payload) {
+      if (payload == "online")
+        this->set_timeout("rediscover", this->jitter_offset_, [this]() { this->rediscover_(); });
+    });
+  }
+#endif
+
+#ifdef USE_MQTT_LATENCY_PROBE
+  this->latency_probe_topic_ = this->topic_prefix_ + "/latency_probe";
+  this->subscribe(
+      this->latency_probe_topic_,
+      [this](const std::string &topic, const std::string &payload) { this->on_latency_probe_(payload); },
+      this->latency_probe_qos_);
+  this->set_interval("latency_probe", this->latency_probe_interval_, [this]() { this->send_latency_probe_(); });
+#endif
+
+#ifdef USE_MQTT_TELEMETRY
+  // Folding the current connection in regularly keeps its millis() difference far from wrapping
+  this->set_interval("connected_time", 60000, [this]() {
+    this->fold_connected_time_();
+#ifdef USE_SENSOR
+    if (this->connected_time_sensor_ != nullptr)
+      this->connected_time_sensor_->publish_state(this->get_connected_time());
+#endif
+  });
+#endif
+
+#ifdef USE_MQTT_DUAL_STACK
+  this->family_pref_ = global_preferences->make_preference<uint8_t>(fnv1_hash("mqtt_address_family"));
+  uint8_t ipv6_first;
+  if (this->family_pref_.load(&ipv6_first))
+    this->ipv6_first_ = ipv6_first != 0;
+#endif
+
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  this->keep_alive_pref_ = global_preferences->make_preference<uint16_t>(fnv1_hash("mqtt_keepalive"));
+  uint16_t keep_alive;
+  if (this->keep_alive_pref_.load(&keep_alive))
+    this->keep_alive_ = keep_alive;
+  this->keep_alive_ = std::clamp(this->keep_alive_, this->keep_alive_min_, this->keep_alive_max_);
+#endif
+
+#ifdef USE_MQTT_FAILOVER
+  // The configured broker is the primary, the failover brokers follow in order
+  this->brokers_.insert(this->brokers_.begin(),
+                        MQTTBroker{this->credentials_.address, this->credentials_.port, this->credentials_.username,
+                                   this->credentials_.password});
+  this->broker_index_pref_ = global_preferences->make_preference<uint8_t>(fnv1_hash("mqtt_broker_index"));
+  uint8_t healthy_index = 0;
+  if (this->broker_index_pref_.load(&healthy_index) && healthy_index != 0 && healthy_index < this->brokers_.size()) {
+    this->healthy_index_ = healthy_index;
+    this->select_broker_(healthy_index);
+  }
+  if (this->failback_interval_ > 0)
+    this->set_interval("failback", this->failback_interval_, [this]() { this->probe_primary_(); });
+#endif
+
+#ifdef USE_MQTT_DNS_CACHE
+  this->broker_pref_ = global_preferences->make_preference<MQTTBrokerAddressCache>(fnv1_hash("mqtt_broker_ip"));
+  MQTTBrokerAddressCache cache{};
+  if (this->broker_pref_.load(&cache) &&
+      cache.address_hash == (fnv1_hash(this->credentials_.address.c_str()) ^ this->credentials_.port)) {
+    this->ip_ = network::IPAddress(&cache.ip);
+    this->ip_cached_ = true;
+    // Connect to it right away, but look the host up again in the background
+    this->resolved_at_ = millis() - this->dns_cache_ttl_ - 1;
+  }
+#endif
+
   if (this->enable_on_boot_) {
     this->enable();
   }
 }
 
+void MQTTClientComponent::schedule_device_info_() {
+  if (this->jitter_offset_ == 0) {
+    this->send_device_info_();
+    return;
+  }
+  // Triggers arriving while a response is already pending are answered by that response
+  if (this->device_info_scheduled_)
+    return;
+  this->device_info_scheduled_ = true;
+  this->set_timeout("device_info", this->jitter_offset_, [this]() {
+    this->device_info_scheduled_ = false;
+    this->send_device_info_();
+  });
+}
+
+void MQTTClientComponent::rediscover_() {
+  ESP_LOGD(TAG, "Home Assistant came online, resending discovery");
+  for (MQTTComponent *component : this->children_)
+    component->schedule_resend_state();
+}
+
 void MQTTClientComponent::send_device_info_() {
   if (!this->is_connected() or !this->is_discovery_ip_enabled()) {
     return;
@@ -106,85 +287,233 @@ void MQTTClientComponent::send_device_info_() {
   char topic[topic_buffer_size];
   buf_append_printf(topic, sizeof(topic), 0, "esphome/discover/%s", App.get_name().c_str());
 
+  // The payload only changes with the IP addresses (and the API key), rebuild it when those do
+  uint32_t fingerprint = 0;
+  for (auto &ip : network::get_ip_addresses()) {
+    if (ip.is_set()) {
+      char ip_buf[network::IP_ADDRESS_BUFFER_SIZE];
+      ip.str_to(ip_buf);
+      fingerprint = fingerprint * 31 + mqtt_payload_hash(ip_buf, strlen(ip_buf));
+    }
+  }
+#ifdef USE_API_NOISE
+  fingerprint = fingerprint * 31 + api::global_api_server->get_noise_ctx().has_psk();
+#endif
+  if (this->device_info_payload_.empty() || fingerprint != this->device_info_fingerprint_) {
+    this->device_info_fingerprint_ = fingerprint;
+    this->build_device_info_payload_();
+  }
+  this->publish(topic, this->device_info_payload_.data(), this->device_info_payload_.size(), 2,
+                this->discovery_info_.retain);
+}
+
+void MQTTClientComponent::build_device_info_payload_() {
   // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
-  this->publish_json(
-      topic,
-      [](JsonObject root) {
-        uint8_t index = 0;
-        for (auto &ip : network::get_ip_addresses()) {
-          if (ip.is_set()) {
-            char key[8];  // "ip" + up to 3 digits + null
-            char ip_buf[network::IP_ADDRESS_BUFFER_SIZE];
-            if (index == 0) {
-              key[0] = 'i';
-              key[1] = 'p';
-              key[2] = '\0';
-            } else {
-              buf_append_printf(key, sizeof(key), 0, "ip%u", index);
-            }
-            ip.str_to(ip_buf);
-            root[key] = ip_buf;
-            index++;
-          }
-        }
-        root[ESPHOME_F("name")] = App.get_name();
-        if (!App.get_friendly_name().empty()) {
-          root[ESPHOME_F("friendly_name")] = App.get_friendly_name();
+  auto payload = json::build_json([](JsonObject root) {
+    uint8_t index = 0;
+    for (auto &ip : network::get_ip_addresses()) {
+      if (ip.is_set()) {
+        char key[8];  // "ip" + up to 3 digits + null
+        char ip_buf[network::IP_ADDRESS_BUFFER_SIZE];
+        if (index == 0) {
+          key[0] = 'i';
+          key[1] = 'p';
+          key[2] = '\0';
+        } else {
+          buf_append_printf(key, sizeof(key), 0, "ip%u", index);
         }
+        ip.str_to(ip_buf);
+        root[key] = ip_buf;
+        index++;
+      }
+    }
+    root[ESPHOME_F("name")] = App.get_name();
+    if (!App.get_friendly_name().empty()) {
+      root[ESPHOME_F("friendly_name")] = App.get_friendly_name();
+    }
 #ifdef USE_API
-        root[ESPHOME_F("port")] = api::global_api_server->get_port();
+    root[ESPHOME_F("port")] = api::global_api_server->get_port();
 #endif
-        root[ESPHOME_F("version")] = ESPHOME_VERSION;
-        char mac_buf[MAC_ADDRESS_BUFFER_SIZE];
-        get_mac_address_into_buffer(mac_buf);
-        root[ESPHOME_F("mac")] = mac_buf;
+    root[ESPHOME_F("version")] = ESPHOME_VERSION;
+    char mac_buf[MAC_ADDRESS_BUFFER_SIZE];
+    get_mac_address_into_buffer(mac_buf);
+    root[ESPHOME_F("mac")] = mac_buf;
 
 #ifdef USE_ESP8266
-        root[ESPHOME_F("platform")] = ESPHOME_F("ESP8266");
+    root[ESPHOME_F("platform")] = ESPHOME_F("ESP8266");
 #endif
 #ifdef USE_ESP32
-        root[ESPHOME_F("platform")] = ESPHOME_F("ESP32");
+    root[ESPHOME_F("platform")] = ESPHOME_F("ESP32");
 #endif
 #ifdef USE_LIBRETINY
-        root[ESPHOME_F("platform")] = lt_cpu_get_model_name();
+    root[ESPHOME_F("platform")] = lt_cpu_get_model_name();
 #endif
 #ifdef USE_RP2040
-        root["platform"] = "RP2040";
+    root["platform"] = "RP2040";
 #endif
 
-        root[ESPHOME_F("board")] = ESPHOME_BOARD;
+    root[ESPHOME_F("board")] = ESPHOME_BOARD;
 #if defined(USE_WIFI)
-        root[ESPHOME_F("network")] = ESPHOME_F("wifi");
+    root[ESPHOME_F("network")] = ESPHOME_F("wifi");
 #elif defined(USE_ETHERNET)
-        root[ESPHOME_F("network")] = ESPHOME_F("ethernet");
+    root[ESPHOME_F("network")] = ESPHOME_F("ethernet");
 #endif
 
 #ifdef ESPHOME_PROJECT_NAME
-        root[ESPHOME_F("project_name")] = ESPHOME_PROJECT_NAME;
-        root[ESPHOME_F("project_version")] = ESPHOME_PROJECT_VERSION;
+    root[ESPHOME_F("project_name")] = ESPHOME_PROJECT_NAME;
+    root[ESPHOME_F("project_version")] = ESPHOME_PROJECT_VERSION;
 #endif  // ESPHOME_PROJECT_NAME
 
 #ifdef USE_DASHBOARD_IMPORT
-        root[ESPHOME_F("package_import_url")] = dashboard_import::get_package_import_url();
+    root[ESPHOME_F("package_import_url")] = dashboard_import::get_package_import_url();
 #endif
 
 #ifdef USE_API_NOISE
-        root[api::global_api_server->get_noise_ctx().has_psk() ? ESPHOME_F("api_encryption")
-                                                               : ESPHOME_F("api_encryption_supported")] =
-            ESPHOME_F("Noise_NNpsk0_25519_ChaChaPoly_SHA256");
+    root[api::global_api_server->get_noise_ctx().has_psk() ? ESPHOME_F("api_encryption")
+                                                           : ESPHOME_F("api_encryption_supported")] =
+        ESPHOME_F("Noise_NNpsk0_25519_ChaChaPoly_SHA256");
 #endif
-      },
-      2, this->discovery_info_.retain);
+  });
+  this->device_info_payload_.assign(payload.c_str(), payload.size());
   // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
 }
 
 #ifdef USE_LOGGER
 void MQTTClientComponent::on_log(uint8_t level, const char *tag, const char *message, size_t message_len) {
+#ifdef USE_MQTT_LOG_ROUTES
+  // Cheap reject before looking up the route: nothing is published above the most verbose configured level
+  if (level > this->log_max_level_)
+    return;
+  const MQTTLogRoute *route = this->find_log_route_(tag);
+  if (route != nullptr) {
+    if (level > route->level)
+      return;
+    if (route->topic != nullptr) {
+#ifdef USE_MQTT_LOG_BUFFER
+      if (this->log_buffer_size_ > 0) {
+        this->buffer_log_line_(route->topic, message, message_len);
+        return;
+      }
+#endif
+      this->publish_log_(route->topic, message, message_len);
+      return;
+    }
+  } else if (level > this->log_level_) {
+    return;
+  }
+#else
   (void) tag;
-  if (level <= this->log_level_ && this->is_connected()) {
-    this->publish(this->log_message_.topic.c_str(), message, message_len, this->log_message_.qos,
-                  this->log_message_.retain);
+  if (level > this->log_level_)
+    return;
+#endif
+#ifdef USE_MQTT_LOG_BUFFER
+  if (this->log_buffer_size_ > 0) {
+    this->buffer_log_line_(nullptr, message, message_len);
+    return;
+  }
+#endif
+  this->publish_log_(this->log_message_.topic.c_str(), message, message_len);
+}
+#endif
+
+#ifdef USE_MQTT_LOG_ROUTES
+void MQTTClientComponent::add_log_route(const char *tag_pattern, uint8_t level, const char *topic) {
+  this->log_routes_.push_back(MQTTLogRoute{tag_pattern, topic, level});
+  if (level > this->log_max_level_)
+    this->log_max_level_ = level;
+}
+
+const MQTTLogRoute *MQTTClientComponent::find_log_route_(const char *tag) {
+  // Tags are static strings, so the pointer identifies the tag. The pattern match runs once per tag and the
+  // result is memoized in a small open-addressed table keyed by that pointer.
+  size_t slot = (reinterpret_cast<uintptr_t>(tag) >> 2) % LOG_ROUTE_CACHE_SIZE;
+  for (size_t probe = 0; probe < LOG_ROUTE_CACHE_SIZE; probe++) {
+    LogRouteCacheEntry &entry = this->log_route_cache_[slot];
+    if (entry.tag == tag)
+      return entry.route < 0 ? nullptr : &this->log_routes_[entry.route];
+    if (entry.tag == nullptr) {
+      entry.tag = tag;
+      entry.route = this->match_log_route_(tag);
+      return entry.route < 0 ? nullptr : &this->log_routes_[entry.route];
+    }
+    slot = (slot + 1) % LOG_ROUTE_CACHE_SIZE;
+  }
+  // Cache full: more distinct tags than slots, fall back to matching every time
+  int16_t route = this->match_log_route_(tag);
+  return route < 0 ? nullptr : &this->log_routes_[route];
+}
+
+int16_t MQTTClientComponent::match_log_route_(const char *tag) const {
+  for (size_t i = 0; i < this->log_routes_.size(); i++) {
+    const char *pattern = this->log_routes_[i].tag_pattern;
+    size_t len = strlen(pattern);
+    bool matches = (len > 0 && pattern[len - 1] == '*') ? strncmp(tag, pattern, len - 1) == 0
+                                                        : strcmp(tag, pattern) == 0;
+    if (matches)
+      return static_cast<int16_t>(i);
   }
+  return -1;
+}
+#endif
+
+#ifdef USE_MQTT_LOG_BUFFER
+void MQTTClientComponent::buffer_log_line_(const char *topic, const char *message, size_t message_len) {
+  // Lines are packed newline separated, in runs of consecutive lines for the same topic (nullptr for the log
+  // topic). Each run goes out as one PUBLISH. Overflow drops the new line and is reported on the next flush.
+  const bool same_run = this->log_run_count_ > 0 && this->log_runs_[this->log_run_count_ - 1].topic == topic;
+  if (!same_run && this->log_run_count_ >= LOG_BUFFER_MAX_RUNS - 1) {
+    this->log_dropped_lines_++;
+    return;
+  }
+  size_t needed = message_len + (same_run ? 1 : 0);
+  if (this->log_buffer_len_ + needed > this->log_buffer_size_) {
+    this->log_dropped_lines_++;
+    return;
+  }
+  if (same_run) {
+    this->log_buffer_[this->log_buffer_len_++] = '\n';
+  } else {
+    this->log_runs_[this->log_run_count_++] = LogBufferRun{this->log_buffer_len_, topic};
+  }
+  memcpy(this->log_buffer_.get() + this->log_buffer_len_, message, message_len);
+  this->log_buffer_len_ += message_len;
+}
+
+void MQTTClientComponent::flush_log_buffer_(uint32_t now) {
+  if ((this->log_buffer_len_ == 0 && this->log_dropped_lines_ == 0) ||
+      now - this->last_log_flush_ < this->log_flush_interval_)
+    return;
+  this->last_log_flush_ = now;
+  if (this->log_dropped_lines_ > 0) {
+    // Goes to the log topic. The buffer has LOG_BUFFER_MARKER_RESERVE spare bytes beyond log_buffer_size_ for
+    // this line, and buffer_log_line_() leaves the last run for it.
+    const bool same_run =
+        this->log_run_count_ > 0 && this->log_runs_[this->log_run_count_ - 1].topic == nullptr;
+    if (!same_run)
+      this->log_runs_[this->log_run_count_++] = LogBufferRun{this->log_buffer_len_, nullptr};
+    this->log_buffer_len_ =
+        buf_append_printf(this->log_buffer_.get(), this->log_buffer_size_ + LOG_BUFFER_MARKER_RESERVE,
+                          this->log_buffer_len_, "%s[dropped %" PRIu32 " lines]", same_run ? "\n" : "",
+                          this->log_dropped_lines_);
+    this->log_dropped_lines_ = 0;
+  }
+  uint8_t sent = 0;
+  for (; sent < this->log_run_count_; sent++) {
+    const LogBufferRun &run = this->log_runs_[sent];
+    const size_t end = sent + 1 < this->log_run_count_ ? this->log_runs_[sent + 1].start : this->log_buffer_len_;
+    const char *topic = run.topic != nullptr ? run.topic : this->log_message_.topic.c_str();
+    if (!this->publish_log_(topic, this->log_buffer_.get() + run.start, end - run.start))
+      break;
+  }
+  if (sent == 0)
+    return;
+  // Keep the runs that did not go out, in order, for the next flush
+  const size_t shift = sent < this->log_run_count_ ? this->log_runs_[sent].start : this->log_buffer_len_;
+  memmove(this->log_buffer_.get(), this->log_buffer_.get() + shift, this->log_buffer_len_ - shift);
+  this->log_buffer_len_ -= shift;
+  for (uint8_t i = sent; i < this->log_run_count_; i++)
+    this->log_runs_[i - sent] = LogBufferRun{this->log_runs_[i].start - shift, this->log_runs_[i].topic};
+  this->log_run_count_ -= sent;
 }
 #endif
 
@@ -201,6 +530,12 @@ void MQTTClientComponent::dump_config() {
                 this->credentials_.username.c_str(), this->credentials_.client_id.c_str(),
                 YESNO(this->credentials_.clean_session));
   // clang-format on
+#ifdef USE_MQTT_FAILOVER
+  for (size_t i = 1; i < this->brokers_.size(); i++) {
+    ESP_LOGCONFIG(TAG, "  Failover Broker %u: %s:%u", static_cast<unsigned>(i), this->brokers_[i].address.c_str(),
+                  this->brokers_[i].port);
+  }
+#endif
   if (this->is_discovery_ip_enabled()) {
     ESP_LOGCONFIG(TAG, "  Discovery IP enabled");
   }
@@ -210,13 +545,88 @@ void MQTTClientComponent::dump_config() {
                   "  Discovery retain: %s",
                   this->discovery_info_.prefix.c_str(), YESNO(this->discovery_info_.retain));
   }
+  if (this->backoff_max_ != this->backoff_initial_ || this->backoff_jitter_) {
+    ESP_LOGCONFIG(TAG,
+                  "  Reconnect backoff: %" PRIu32 "ms to %" PRIu32 "ms, x%.1f\n"
+                  "  Reconnect jitter: %s",
+                  this->backoff_initial_, this->backoff_max_, this->backoff_multiplier_,
+                  YESNO(this->backoff_jitter_));
+  }
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  ESP_LOGCONFIG(TAG, "  Keep alive: %us (adaptive %us to %us)", this->keep_alive_, this->keep_alive_min_,
+                this->keep_alive_max_);
+#endif
+  if (this->first_state_at_ != 0) {
+    ESP_LOGCONFIG(TAG, "  First state published: %" PRIu32 "ms after boot", this->first_state_at_);
+  }
+  if (this->discovery_jitter_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Discovery jitter: %" PRIu32 "ms (offset %" PRIu32 "ms)", this->discovery_jitter_,
+                  this->jitter_offset_);
+  }
+#ifdef USE_MQTT_TELEMETRY
+  ESP_LOGCONFIG(TAG,
+                "  Telemetry:\n"
+                "    DNS time: p50 %" PRIu32 "ms, p95 %" PRIu32 "ms, max %" PRIu32 "ms (%" PRIu32 " lookups)\n"
+                "    Connect time: p50 %" PRIu32 "ms, p95 %" PRIu32 "ms, max %" PRIu32 "ms (%" PRIu32 " connects)\n"
+                "    Loop time: p50 %" PRIu32 "us, p95 %" PRIu32 "us, max %" PRIu32 "us (%" PRIu32 " loops)\n"
+                "    Connected: %" PRIu32 "s",
+                this->dns_time_histogram_.percentile(50), this->dns_time_histogram_.percentile(95),
+                this->dns_time_histogram_.max(), this->dns_time_histogram_.count(),
+                this->connect_time_histogram_.percentile(50), this->connect_time_histogram_.percentile(95),
+                this->connect_time_histogram_.max(), this->connect_time_histogram_.count(),
+                this->loop_time_histogram_.percentile(50), this->loop_time_histogram_.percentile(95),
+                this->loop_time_histogram_.max(), this->loop_time_histogram_.count(), this->get_connected_time());
+  for (uint8_t i = 0; i < MQTT_DISCONNECT_REASON_COUNT; i++) {
+    if (this->disconnect_counts_[i] == 0)
+      continue;
+    ESP_LOGCONFIG(TAG, "    Disconnects (%s): %u",
+                  LOG_STR_ARG(MQTTDisconnectReasonStrings::get_log_str(i, MQTTDisconnectReasonStrings::LAST_INDEX)),
+                  this->disconnect_counts_[i]);
+  }
+#endif
+#ifdef USE_MQTT_LATENCY_PROBE
+  ESP_LOGCONFIG(TAG,
+                "  Latency probe: every %" PRIu32 "ms, QoS %u\n"
+                "    Round trip: p50 %" PRIu32 "ms, p95 %" PRIu32 "ms, max %" PRIu32 "ms (%" PRIu32
+                " echoed, %" PRIu32 " lost)",
+                this->latency_probe_interval_, this->latency_probe_qos_, this->latency_histogram_.percentile(50),
+                this->latency_histogram_.percentile(95), this->latency_histogram_.max(),
+                this->latency_histogram_.count(), this->latency_probes_lost_);
+#endif
   ESP_LOGCONFIG(TAG, "  Topic Prefix: '%s'", this->topic_prefix_.c_str());
   if (!this->log_message_.topic.empty()) {
     ESP_LOGCONFIG(TAG, "  Log Topic: '%s'", this->log_message_.topic.c_str());
+#ifdef USE_MQTT_LOG_ROUTES
+    for (const auto &route : this->log_routes_) {
+      ESP_LOGCONFIG(TAG, "    Route '%s': level %u, topic '%s'", route.tag_pattern, route.level,
+                    route.topic != nullptr ? route.topic : this->log_message_.topic.c_str());
+    }
+#endif
+#ifdef USE_MQTT_LOG_BUFFER
+    if (this->log_buffer_size_ > 0) {
+      ESP_LOGCONFIG(TAG,
+                    "  Log Buffer: %u bytes\n"
+                    "  Log Flush Interval: %" PRIu32 "ms",
+                    static_cast<unsigned>(this->log_buffer_size_), this->log_flush_interval_);
+    }
+#endif
   }
   if (!this->availability_.topic.empty()) {
     ESP_LOGCONFIG(TAG, "  Availability: '%s'", this->availability_.topic.c_str());
   }
+#ifdef USE_MQTT_MSGPACK
+  ESP_LOGCONFIG(TAG, "  Payload Format: MessagePack");
+#endif
+#ifdef USE_MQTT_COMPRESSION
+  ESP_LOGCONFIG(TAG,
+                "  Compression: heatshrink (window %u, lookahead %u, size %u-%u, suffix '%s')",
+                this->compression_window_bits_, this->compression_lookahead_bits_,
+                static_cast<unsigned>(this->compression_min_size_), static_cast<unsigned>(this->compression_max_size_),
+                this->compression_topic_suffix_);
+  for (const char *filter : this->compressed_topics_) {
+    ESP_LOGCONFIG(TAG, "    Topic: '%s'", filter);
+  }
+#endif
 }
 bool MQTTClientComponent::can_proceed() {
   return network::is_disabled() || this->state_ == MQTT_CLIENT_DISABLED || this->is_connected() ||
@@ -229,20 +639,55 @@ void MQTTClientComponent::start_dnslookup_() {
     subscription.resubscribe_timeout = 0;
   }
 
+#ifdef USE_MQTT_FAILOVER
+  if (this->attempt_pending_)
+    this->on_connect_failed_();
+  if (this->failed_attempts_ == 0)
+    this->broker_attempts_start_ = millis();
+  this->attempt_pending_ = true;
+#endif
+
   this->status_set_warning();
   this->dns_resolve_error_ = false;
   this->dns_resolved_ = false;
+#ifdef USE_MQTT_DNS_CACHE
+  if (this->ip_cached_) {
+    if (millis() - this->resolved_at_ > this->dns_cache_ttl_) {
+      // Refresh in the background: dns_found_callback() updates ip_ for the next attempt.
+      // lwIP answers from its own cache, which honours the record's TTL, when it still can.
+      this->resolved_at_ = millis();
+      ip_addr_t addr;
+      LwIPLock lock;
+      err_t err = dns_gethostbyname_addrtype(this->credentials_.address.c_str(), &addr,
+                                             MQTTClientComponent::dns_found_callback, this, MQTT_DNS_ADDRTYPE);
+      if (err == ERR_OK) {
+        this->ip_ = network::IPAddress(&addr);
+      } else if (err == ERR_INPROGRESS) {
+        this->dns_pending_ = true;
+      }
+    }
+    this->connect_from_cache_ = true;
+    this->start_connect_();
+    return;
+  }
+  this->connect_from_cache_ = false;
+#endif
+#ifdef USE_MQTT_DUAL_STACK
+  this->start_address_race_();
+#else
+  this->resolve_broker_();
+#endif
+}
+
+void MQTTClientComponent::resolve_broker_() {
   ip_addr_t addr;
   err_t err;
   {
     LwIPLock lock;
-#if USE_NETWORK_IPV6
-    err = dns_gethostbyname_addrtype(this->credentials_.address.c_str(), &addr, MQTTClientComponent::dns_found_callback,
-                                     this, LWIP_DNS_ADDRTYPE_IPV6_IPV4);
-#else
     err = dns_gethostbyname_addrtype(this->credentials_.address.c_str(), &addr, MQTTClientComponent::dns_found_callback,
-                                     this, LWIP_DNS_ADDRTYPE_IPV4);
-#endif /* USE_NETWORK_IPV6 */
+                                     this, MQTT_DNS_ADDRTYPE);
+    if (err == ERR_INPROGRESS)
+      this->dns_pending_ = true;
   }
   switch (err) {
     case ERR_OK: {
@@ -275,7 +720,7 @@ void MQTTClientComponent::check_dnslookup_() {
 
   if (this->dns_resolve_error_) {
     ESP_LOGW(TAG, "Couldn't resolve IP address for '%s'", this->credentials_.address.c_str());
-    this->state_ = MQTT_CLIENT_DISCONNECTED;
+    this->set_disconnected_();
     this->disconnect_reason_ = MQTTClientDisconnectReason::DNS_RESOLVE_ERROR;
     this->on_disconnect_.call(MQTTClientDisconnectReason::DNS_RESOLVE_ERROR);
     return;
@@ -287,14 +732,36 @@ void MQTTClientComponent::check_dnslookup_() {
 
   char ip_buf[network::IP_ADDRESS_BUFFER_SIZE];
   ESP_LOGD(TAG, "Resolved broker IP address to %s", this->ip_.str_to(ip_buf));
+#ifdef USE_MQTT_TELEMETRY
+  this->record_dns_time_(millis() - this->connect_begin_);
+#endif
+#ifdef USE_MQTT_DNS_CACHE
+  this->resolved_at_ = millis();
+#endif
   this->start_connect_();
 }
+
+#ifdef USE_MQTT_TELEMETRY
+void MQTTClientComponent::record_dns_time_(uint32_t dns_time) {
+  this->dns_time_histogram_.record(dns_time);
+#ifdef USE_SENSOR
+  if (this->dns_time_sensor_ != nullptr)
+    this->dns_time_sensor_->publish_state(dns_time);
+#endif
+}
+#endif
+
 #if defined(USE_ESP8266) && LWIP_VERSION_MAJOR == 1
 void MQTTClientComponent::dns_found_callback(const char *name, ip_addr_t *ipaddr, void *callback_arg) {
 #else
 void MQTTClientComponent::dns_found_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg) {
 #endif
   auto *a_this = (MQTTClientComponent *) callback_arg;
+  // Runs in lwIP's context. An answer for the host of a previous broker, or for a lookup select_broker_()
+  // abandoned, must not end up in ip_ next to the current broker's credentials.
+  if (!a_this->dns_pending_ || strcasecmp(name, a_this->credentials_.address.c_str()) != 0)
+    return;
+  a_this->dns_pending_ = false;
   if (ipaddr == nullptr) {
     a_this->dns_resolve_error_ = true;
   } else {
@@ -303,6 +770,141 @@ void MQTTClientComponent::dns_found_callback(const char *name, const ip_addr_t *
   }
 }
 
+#ifdef USE_MQTT_DUAL_STACK
+void MQTTClientComponent::start_address_race_() {
+  const uint32_t now = millis();
+  this->state_ = MQTT_CLIENT_RESOLVING_ADDRESS;
+  this->connect_begin_ = now;
+  this->address_race_.start(now, this->ipv6_first_, this->family_fallback_timeout_);
+  const char *host = this->credentials_.address.c_str();
+  ip_addr_t addr;
+  if (ipaddr_aton(host, &addr)) {
+    // A literal address only exists in its own family
+    const uint8_t family = IP_IS_V6(&addr) ? MQTTAddressRace::FAMILY_IPV6 : MQTTAddressRace::FAMILY_IPV4;
+    this->family_ips_[family] = network::IPAddress(&addr);
+    this->family_dns_[family] = FAMILY_DNS_RESOLVED;
+    this->family_dns_[family ^ 1] = FAMILY_DNS_FAILED;
+    return;
+  }
+  ESP_LOGD(TAG, "Resolving broker IP addresses");
+  // Both lookups run in parallel, lwIP keeps separate table entries per address type
+  for (uint8_t family = 0; family < 2; family++) {
+    this->family_dns_[family] = FAMILY_DNS_PENDING;
+    err_t err;
+    {
+      LwIPLock lock;
+      if (family == MQTTAddressRace::FAMILY_IPV6) {
+        err = dns_gethostbyname_addrtype(host, &addr, MQTTClientComponent::dns_found_ipv6_callback, this,
+                                         LWIP_DNS_ADDRTYPE_IPV6);
+      } else {
+        err = dns_gethostbyname_addrtype(host, &addr, MQTTClientComponent::dns_found_ipv4_callback, this,
+                                         LWIP_DNS_ADDRTYPE_IPV4);
+      }
+    }
+    if (err == ERR_OK) {
+      this->family_ips_[family] = network::IPAddress(&addr);
+      this->family_dns_[family] = FAMILY_DNS_RESOLVED;
+    } else if (err != ERR_INPROGRESS) {
+      this->family_dns_[family] = FAMILY_DNS_FAILED;
+    }
+  }
+}
+
+void MQTTClientComponent::dns_found_ipv6_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg) {
+  static_cast<MQTTClientComponent *>(callback_arg)->on_family_resolved_(MQTTAddressRace::FAMILY_IPV6, ipaddr);
+}
+
+void MQTTClientComponent::dns_found_ipv4_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg) {
+  static_cast<MQTTClientComponent *>(callback_arg)->on_family_resolved_(MQTTAddressRace::FAMILY_IPV4, ipaddr);
+}
+
+void MQTTClientComponent::on_family_resolved_(uint8_t family, const ip_addr_t *ipaddr) {
+  // Runs in lwIP's context, check_address_race_() hands the result to the race
+  if (this->family_dns_[family] != FAMILY_DNS_PENDING)
+    return;
+  if (ipaddr != nullptr)
+    this->family_ips_[family] = network::IPAddress(ipaddr);
+  this->family_dns_[family] = ipaddr != nullptr ? FAMILY_DNS_RESOLVED : FAMILY_DNS_FAILED;
+}
+
+void MQTTClientComponent::check_address_race_() {
+  const uint32_t now = millis();
+  for (uint8_t family = 0; family < 2; family++) {
+    const auto race_family = static_cast<MQTTAddressRace::Family>(family);
+    const FamilyDnsState dns = this->family_dns_[family];
+    if (dns == FAMILY_DNS_RESOLVED || dns == FAMILY_DNS_FAILED) {
+      this->family_dns_[family] = FAMILY_DNS_REPORTED;
+      if (dns == FAMILY_DNS_RESOLVED) {
+        char ip_buf[network::IP_ADDRESS_BUFFER_SIZE];
+        ESP_LOGD(TAG, "Resolved broker IP address to %s", this->family_ips_[family].str_to(ip_buf));
+#ifdef USE_MQTT_TELEMETRY
+        if (!this->address_race_.any_resolved())
+          this->record_dns_time_(now - this->connect_begin_);
+#endif
+      }
+      this->address_race_.resolved(race_family, dns == FAMILY_DNS_RESOLVED);
+    }
+    const MQTTTcpProbe::State probe = this->family_probes_[family].state();
+    if (probe == MQTTTcpProbe::CONNECTED || probe == MQTTTcpProbe::FAILED) {
+      this->family_probes_[family].cancel();
+      this->address_race_.probed(race_family, probe == MQTTTcpProbe::CONNECTED);
+    }
+  }
+
+  for (;;) {
+    const MQTTAddressRace::Action action = this->address_race_.poll(now);
+    switch (action) {
+      case MQTTAddressRace::ACTION_PROBE_IPV6:
+      case MQTTAddressRace::ACTION_PROBE_IPV4: {
+        const uint8_t family = action == MQTTAddressRace::ACTION_PROBE_IPV6 ? MQTTAddressRace::FAMILY_IPV6
+                                                                             : MQTTAddressRace::FAMILY_IPV4;
+        char ip_buf[network::IP_ADDRESS_BUFFER_SIZE];
+        ESP_LOGD(TAG, "Trying %s", this->family_ips_[family].str_to(ip_buf));
+        this->family_probes_[family].start(this->family_ips_[family], this->credentials_.port);
+        continue;
+      }
+      case MQTTAddressRace::ACTION_CONNECT: {
+        // The winner's handshake just completed, so the backend connects over a path known to work
+        const uint8_t winner = this->address_race_.winner();
+        this->family_probes_[winner ^ 1].cancel();
+        this->ip_ = this->family_ips_[winner];
+        this->start_connect_();
+        return;
+      }
+      case MQTTAddressRace::ACTION_FAILED:
+        this->fail_address_race_(this->address_race_.any_resolved() ? MQTTClientDisconnectReason::TCP_DISCONNECTED
+                                                                    : MQTTClientDisconnectReason::DNS_RESOLVE_ERROR);
+        return;
+      default:
+        break;
+    }
+    break;
+  }
+
+  // Handshakes that are neither answered nor refused (a blackholed family) end here
+  if (!this->address_race_.any_resolved() && now - this->connect_begin_ > 20000) {
+    this->fail_address_race_(MQTTClientDisconnectReason::DNS_RESOLVE_ERROR);
+  } else if (now - this->connect_begin_ > this->connect_timeout_) {
+    this->fail_address_race_(MQTTClientDisconnectReason::TCP_DISCONNECTED);
+  }
+}
+
+void MQTTClientComponent::fail_address_race_(MQTTClientDisconnectReason reason) {
+  for (uint8_t family = 0; family < 2; family++) {
+    this->family_probes_[family].cancel();
+    this->family_dns_[family] = FAMILY_DNS_REPORTED;  // Ignore lookups that are still running
+  }
+  if (reason == MQTTClientDisconnectReason::DNS_RESOLVE_ERROR) {
+    ESP_LOGW(TAG, "Couldn't resolve IP address for '%s'", this->credentials_.address.c_str());
+  } else {
+    ESP_LOGW(TAG, "Couldn't reach '%s' over IPv6 or IPv4", this->credentials_.address.c_str());
+  }
+  this->set_disconnected_();
+  this->disconnect_reason_ = reason;
+  this->on_disconnect_.call(reason);
+}
+#endif
+
 void MQTTClientComponent::start_connect_() {
   if (!network::is_connected())
     return;
@@ -321,8 +923,23 @@ void MQTTClientComponent::start_connect_() {
     password = this->credentials_.password.c_str();
 
   this->mqtt_backend_.set_credentials(username, password);
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  // Only changed here: the broker enforces the keep alive sent in CONNECT for the whole connection
+  this->mqtt_backend_.set_keep_alive(this->keep_alive_);
+  this->connection_keep_alive_ = this->keep_alive_;
+#endif
 
+#ifdef USE_MQTT_DNS_CACHE
+  // Connect to the address resolved (or cached) here instead of having the backend look it up again
+  this->connect_ip_ = this->ip_;
+  this->mqtt_backend_.set_server(this->connect_ip_, this->credentials_.port);
+#elif defined(USE_MQTT_DUAL_STACK)
+  // Connect to the address that won the race in check_address_race_(), the backend would pick its own
+  this->connect_ip_ = this->ip_;
+  this->mqtt_backend_.set_server(this->connect_ip_, this->credentials_.port);
+#else
   this->mqtt_backend_.set_server(this->credentials_.address.c_str(), this->credentials_.port);
+#endif
   if (!this->last_will_.topic.empty()) {
     this->mqtt_backend_.set_will(this->last_will_.topic.c_str(), this->last_will_.qos, this->last_will_.retain,
                                  this->last_will_.payload.c_str());
@@ -338,9 +955,13 @@ bool MQTTClientComponent::is_connected() {
 
 void MQTTClientComponent::check_connected() {
   if (!this->mqtt_backend_.connected()) {
-    if (millis() - this->connect_begin_ > 60000) {
-      this->state_ = MQTT_CLIENT_DISCONNECTED;
-      this->start_dnslookup_();
+    if (millis() - this->connect_begin_ > this->connect_timeout_) {
+      ESP_LOGW(TAG, "Connect timed out");
+#ifdef USE_MQTT_DNS_CACHE
+      this->drop_cached_ip_();
+#endif
+      // The next attempt waits for the backoff like any other failed connect
+      this->set_disconnected_();
     }
     return;
   }
@@ -348,18 +969,563 @@ void MQTTClientComponent::check_connected() {
   this->state_ = MQTT_CLIENT_CONNECTED;
   this->sent_birth_message_ = false;
   this->status_clear_warning();
-  ESP_LOGI(TAG, "Connected");
-  // MQTT Client needs some time to be fully set up.
-  delay(100);  // NOLINT
-
-  this->resubscribe_subscriptions_();
-  this->send_device_info_();
+  // Time since start_connect_(): TCP and TLS handshakes plus CONNECT/CONNACK
+  const uint32_t connect_duration = millis() - this->connect_begin_;
+  ESP_LOGI(TAG, "Connected in %" PRIu32 "ms", connect_duration);
+#ifdef USE_SENSOR
+  if (this->connect_duration_sensor_ != nullptr)
+    this->connect_duration_sensor_->publish_state(connect_duration);
+#endif
+#ifdef USE_MQTT_TELEMETRY
+  this->connect_time_histogram_.record(connect_duration);
+  this->telemetry_connected_at_ = millis();
+  this->telemetry_connected_ = true;
+  if (this->connects_ < UINT16_MAX)
+    this->connects_++;
+#ifdef USE_SENSOR
+  if (this->reconnects_sensor_ != nullptr)
+    this->reconnects_sensor_->publish_state(this->connects_ - 1);
+#endif
+#endif
+  this->backoff_ = this->backoff_initial_;
+  this->next_reconnect_delay_();
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  this->keep_alive_stable_at_ = millis() | 1;
+  this->last_rx_ = millis();  // The CONNACK
+#endif
+#ifdef USE_MQTT_DUAL_STACK
+  this->ipv6_first_ = this->connect_ip_.is_ip6();
+  uint8_t ipv6_first = this->ipv6_first_;
+  this->family_pref_.save(&ipv6_first);
+#endif
+#ifdef USE_MQTT_FAILOVER
+  this->attempt_pending_ = false;
+  this->probing_primary_ = false;
+  this->failed_attempts_ = 0;
+  if (this->healthy_index_ != this->broker_index_) {
+    this->healthy_index_ = this->broker_index_;
+    this->broker_index_pref_.save(&this->healthy_index_);
+  }
+#endif
+#ifdef USE_MQTT_DNS_CACHE
+  if (!this->connected_once_) {
+    this->connected_once_ = true;
+    ESP_LOGD(TAG, "First CONNACK %" PRIu32 "ms after boot (%s address)", millis(),
+             this->connect_from_cache_ ? "cached" : "resolved");
+  }
+  // Preferences only hit flash when the stored address actually changes
+  MQTTBrokerAddressCache cache{};
+  cache.address_hash = fnv1_hash(this->credentials_.address.c_str()) ^ this->credentials_.port;
+  cache.ip = this->connect_ip_;
+  this->broker_pref_.save(&cache);
+  this->ip_cached_ = true;
+#endif
+  // MQTT Client needs some time to be fully set up, loop() holds off until MQTT_CONNECT_SETTLE_TIME has passed
+  this->connected_at_ = millis();
+  this->settled_ = false;
 
   for (MQTTComponent *component : this->children_)
     component->schedule_resend_state();
+  // Measure connect to fully synced, see process_resends_(); 0 means not measuring
+  this->sync_start_ = millis() | 1;
+  this->resend_backoff_ = 0;
+#ifdef USE_MQTT_BURST
+  this->restore_subscriptions_();
+#endif
+}
+
+#ifdef USE_MQTT_BURST
+void MQTTClientComponent::restore_subscriptions_() {
+  uint32_t hash = 0;
+  for (const auto &subscription : this->subscriptions_)
+    hash = hash * 31 + mqtt_payload_hash(subscription.topic.data(), subscription.topic.size()) + subscription.qos;
+  if (this->session_present_ && hash == this->subscriptions_hash_) {
+    for (auto &subscription : this->subscriptions_)
+      subscription.subscribed = true;
+    return;
+  }
+  this->subscriptions_hash_ = hash;
+  this->subscriptions_pref_.save(&hash);
 }
 
+void MQTTClientComponent::check_burst_complete_() {
+  // sync_start_ is cleared by process_resends_() once everything scheduled at connect went out
+  if (this->burst_complete_ || this->sync_start_ != 0 || this->inflight_ != 0)
+    return;
+  // Entities without a state yet (e.g. a sensor whose first reading lands after CONNACK) publish from their
+  // state callback once it arrives, which also counts towards inflight_ for QoS > 0
+  for (MQTTComponent *component : this->children_) {
+    if (!component->has_initial_state())
+      return;
+  }
+  this->burst_complete_ = true;
+  // Waking from deep sleep is a boot, so uptime is the wake-to-sleep time
+  const uint32_t elapsed = millis();
+  ESP_LOGD(TAG, "Burst complete %" PRIu32 "ms after wake", elapsed);
+  this->on_burst_complete_.call(elapsed);
+}
+#endif
+
+#ifdef USE_MQTT_DNS_CACHE
+void MQTTClientComponent::drop_cached_ip_() {
+  if (!this->connect_from_cache_)
+    return;
+  ESP_LOGD(TAG, "Cached broker address failed, resolving again");
+  this->ip_cached_ = false;
+  this->connect_from_cache_ = false;
+}
+#endif
+
+#ifdef USE_MQTT_FAILOVER
+void MQTTClientComponent::select_broker_(uint8_t index) {
+  const MQTTBroker &broker = this->brokers_[index];
+  {
+    // Serialized with dns_found_callback(): a lookup of the previous host still in flight is dropped
+    LwIPLock lock;
+    this->dns_pending_ = false;
+    this->credentials_.address = broker.address;
+  }
+  this->credentials_.port = broker.port;
+  this->credentials_.username = broker.username;
+  this->credentials_.password = broker.password;
+  this->broker_index_ = index;
+#ifdef USE_MQTT_DNS_CACHE
+  this->ip_cached_ = false;  // The cached address belongs to the previous broker
+  this->connect_from_cache_ = false;
+#endif
+  ESP_LOGI(TAG, "Using broker %u: %s:%u", index, broker.address.c_str(), broker.port);
+}
+
+void MQTTClientComponent::on_connect_failed_() {
+  if (this->probing_primary_) {
+    // The primary accepted TCP but not our session, go straight back to the broker that worked
+    this->probing_primary_ = false;
+    this->failed_attempts_ = 0;
+    this->select_broker_(this->healthy_index_);
+    return;
+  }
+  if (this->brokers_.size() < 2)
+    return;
+  // Bounded by count and by time: with a long backoff a few attempts could otherwise take many minutes
+  if (++this->failed_attempts_ < this->failover_attempts_ &&
+      millis() - this->broker_attempts_start_ < this->connect_timeout_)
+    return;
+  this->failed_attempts_ = 0;
+  this->select_broker_((this->broker_index_ + 1) % this->brokers_.size());
+}
+
+void MQTTClientComponent::probe_primary_() {
+  if (this->broker_index_ == 0 || this->state_ != MQTT_CLIENT_CONNECTED || this->failback_state_ != FAILBACK_IDLE)
+    return;
+  ESP_LOGD(TAG, "Checking whether the primary broker is back");
+  this->failback_state_ = FAILBACK_RESOLVING;
+  this->failback_started_at_ = millis();
+  ip_addr_t addr;
+  err_t err;
+  {
+    LwIPLock lock;
+    err = dns_gethostbyname_addrtype(this->brokers_[0].address.c_str(), &addr,
+                                     MQTTClientComponent::failback_dns_callback, this, MQTT_DNS_ADDRTYPE);
+  }
+  if (err == ERR_OK) {
+    this->failback_ip_ = network::IPAddress(&addr);
+    this->failback_state_ = FAILBACK_RESOLVED;
+  } else if (err != ERR_INPROGRESS) {
+    this->failback_state_ = FAILBACK_IDLE;
+  }
+}
+
+#if defined(USE_ESP8266) && LWIP_VERSION_MAJOR == 1
+void MQTTClientComponent::failback_dns_callback(const char *name, ip_addr_t *ipaddr, void *callback_arg) {
+#else
+void MQTTClientComponent::failback_dns_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg) {
+#endif
+  auto *a_this = (MQTTClientComponent *) callback_arg;
+  if (a_this->failback_state_ != FAILBACK_RESOLVING)
+    return;
+  if (ipaddr == nullptr) {
+    a_this->failback_state_ = FAILBACK_IDLE;
+  } else {
+    a_this->failback_ip_ = network::IPAddress(ipaddr);
+    a_this->failback_state_ = FAILBACK_RESOLVED;
+  }
+}
+
+void MQTTClientComponent::check_failback_() {
+  if (this->state_ != MQTT_CLIENT_CONNECTED || millis() - this->failback_started_at_ > this->connect_timeout_) {
+    // Lost the session meanwhile (the reconnect logic takes over) or the primary never answered
+    this->failback_probe_.cancel();
+    this->failback_state_ = FAILBACK_IDLE;
+    return;
+  }
+  if (this->failback_state_ == FAILBACK_RESOLVED) {
+    this->failback_probe_.start(this->failback_ip_, this->brokers_[0].port);
+    this->failback_state_ = FAILBACK_PROBING;
+  }
+  if (this->failback_state_ != FAILBACK_PROBING)
+    return;
+  switch (this->failback_probe_.state()) {
+    case MQTTTcpProbe::PENDING:
+      return;
+    case MQTTTcpProbe::CONNECTED:
+      ESP_LOGI(TAG, "Primary broker accepts connections again, failing back");
+      this->probing_primary_ = true;
+      this->select_broker_(0);
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+      this->keep_alive_stable_at_ = 0;  // A planned disconnect says nothing about the path
+#endif
+      this->mqtt_backend_.disconnect();
+      this->set_disconnected_();
+      break;
+    default:
+      ESP_LOGD(TAG, "Primary broker still unreachable");
+      break;
+  }
+  this->failback_probe_.cancel();
+  this->failback_state_ = FAILBACK_IDLE;
+}
+#endif
+
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+void MQTTClientComponent::check_keep_alive_drop_(bool tcp_drop) {
+  if (this->keep_alive_stable_at_ == 0)
+    return;  // Planned disconnect, or already handled for this connection
+  this->keep_alive_stable_at_ = 0;
+  // A NAT or firewall that forgets an idle connection drops it after a quiet stretch: the network is up, the
+  // connection outlived one keep alive interval and nothing arrived for one either. A drop during traffic,
+  // or one that repeats only once, points at something else than the keep alive.
+  const uint32_t now = millis();
+  const uint32_t interval = this->connection_keep_alive_ * 1000u;
+  if (!tcp_drop || !network::is_connected() || now - this->connected_at_ < interval ||
+      now - this->last_rx_ < interval) {
+    this->keep_alive_timeouts_ = 0;
+    return;
+  }
+  if (++this->keep_alive_timeouts_ < MQTT_KEEPALIVE_TIMEOUT_DROPS)
+    return;
+  this->keep_alive_timeouts_ = 0;
+  this->adapt_keep_alive_(false);
+}
+
+void MQTTClientComponent::adapt_keep_alive_(bool stable) {
+  const uint16_t keep_alive = stable ? std::min<uint32_t>(this->keep_alive_ * 2u, this->keep_alive_max_)
+                                     : std::max<uint16_t>(this->keep_alive_ / 2, this->keep_alive_min_);
+  if (keep_alive == this->keep_alive_)
+    return;
+  ESP_LOGD(TAG, "Keep alive %us -> %us from the next connect", this->keep_alive_, keep_alive);
+  this->keep_alive_ = keep_alive;
+  this->keep_alive_pref_.save(&this->keep_alive_);
+}
+#endif
+
+#ifdef USE_MQTT_TELEMETRY
+void MQTTClientComponent::record_disconnect_(MQTTClientDisconnectReason reason) {
+  const auto index = static_cast<uint8_t>(reason);
+  if (index < MQTT_DISCONNECT_REASON_COUNT && this->disconnect_counts_[index] < UINT16_MAX)
+    this->disconnect_counts_[index]++;
+  this->fold_connected_time_();
+  this->telemetry_connected_ = false;
+#ifdef USE_SENSOR
+  if (this->disconnects_sensor_ != nullptr) {
+    uint32_t disconnects = 0;
+    for (uint16_t count : this->disconnect_counts_)
+      disconnects += count;
+    this->disconnects_sensor_->publish_state(disconnects);
+  }
+  if (this->connected_time_sensor_ != nullptr)
+    this->connected_time_sensor_->publish_state(this->get_connected_time());
+#endif
+}
+
+void MQTTClientComponent::fold_connected_time_() {
+  if (!this->telemetry_connected_)
+    return;
+  // Whole seconds only, the remainder stays in telemetry_connected_at_
+  const uint32_t elapsed = millis() - this->telemetry_connected_at_;
+  this->connected_s_ += elapsed / 1000;
+  this->telemetry_connected_at_ += elapsed - elapsed % 1000;
+}
+
+uint32_t MQTTClientComponent::get_connected_time() const {
+  if (!this->telemetry_connected_)
+    return this->connected_s_;
+  return this->connected_s_ + (millis() - this->telemetry_connected_at_) / 1000;
+}
+#endif
+
+#ifdef USE_MQTT_LATENCY_PROBE
+void MQTTClientComponent::send_latency_probe_() {
+  if (!this->is_connected())
+    return;
+  if (this->latency_probe_sent_at_ != 0) {
+    this->latency_probes_lost_++;
+    ESP_LOGD(TAG, "Latency probe was not echoed within %" PRIu32 "ms", this->latency_probe_interval_);
+  }
+  // The payload identifies the probe, echoes of older probes (e.g. queued in a persistent session) are ignored
+  this->latency_probe_sent_at_ = millis() | 1;
+  char payload[11];
+  size_t len = buf_append_printf(payload, sizeof(payload), 0, "%" PRIu32, this->latency_probe_sent_at_);
+  if (!this->publish(this->latency_probe_topic_.c_str(), payload, len, this->latency_probe_qos_, false))
+    this->latency_probe_sent_at_ = 0;
+}
+
+void MQTTClientComponent::on_latency_probe_(const std::string &payload) {
+  auto sent_at = parse_number<uint32_t>(payload);
+  if (!sent_at.has_value() || *sent_at != this->latency_probe_sent_at_ || this->latency_probe_sent_at_ == 0)
+    return;
+  const uint32_t latency = millis() - this->latency_probe_sent_at_;
+  this->latency_probe_sent_at_ = 0;
+  this->latency_histogram_.record(latency);
+  ESP_LOGV(TAG, "Broker round trip %" PRIu32 "ms", latency);
+#ifdef USE_SENSOR
+  if (this->latency_p50_sensor_ != nullptr)
+    this->latency_p50_sensor_->publish_state(this->latency_histogram_.percentile(50));
+  if (this->latency_p95_sensor_ != nullptr)
+    this->latency_p95_sensor_->publish_state(this->latency_histogram_.percentile(95));
+  if (this->latency_max_sensor_ != nullptr)
+    this->latency_max_sensor_->publish_state(this->latency_histogram_.max());
+#endif
+}
+#endif
+
+void MQTTClientComponent::next_reconnect_delay_() {
+  // Full jitter: spread a fleet that lost the broker at the same moment over the whole backoff window
+  this->reconnect_delay_ = this->backoff_jitter_ ? random_uint32() % (this->backoff_ + 1) : this->backoff_;
+  const float next = this->backoff_ * this->backoff_multiplier_;
+  this->backoff_ = next >= this->backoff_max_ ? this->backoff_max_ : static_cast<uint32_t>(next);
+#ifdef USE_SENSOR
+  if (this->reconnect_backoff_sensor_ != nullptr)
+    this->reconnect_backoff_sensor_->publish_state(this->reconnect_delay_);
+#endif
+}
+
+void MQTTClientComponent::set_disconnected_() {
+  this->state_ = MQTT_CLIENT_DISCONNECTED;
+  this->disconnected_at_ = millis();
+}
+
+bool MQTTClientComponent::resend_failed_(bool failed) {
+  if (!failed) {
+    this->resend_backoff_ = 0;
+    return false;
+  }
+  this->resend_failed_at_ = millis();
+  this->resend_backoff_ = this->resend_backoff_ == 0 ? MQTT_RESEND_BACKOFF_MIN
+                                                     : std::min(this->resend_backoff_ * 2, MQTT_RESEND_BACKOFF_MAX);
+  return true;
+}
+
+void MQTTClientComponent::process_resends_() {
+  // Process pending resends for all MQTT components centrally. Work per loop iteration is bounded by a
+  // time budget rather than a count (one climate discovery costs far more than a binary sensor state) to
+  // avoid triggering the task WDT on reconnect. At least one resend runs per iteration so progress is
+  // guaranteed. State goes out before discovery so values are fresh as early as possible.
+#ifdef USE_MQTT_BURST
+  // Publish everything in a single pass so the node can go back to sleep as soon as possible
+  const uint32_t budget = UINT32_MAX;
+#else
+  const uint32_t budget = this->resend_budget_us_;
+#endif
+  // A failed resend means the send buffer is full, retrying on every loop iteration would only rebuild
+  // payloads that cannot go out until it drains
+  if (this->resend_backoff_ != 0 && millis() - this->resend_failed_at_ < this->resend_backoff_)
+    return;
+  const uint32_t start = micros();
+  bool processed = false;
+  for (MQTTComponent *component : this->children_) {
+    if (!component->is_state_resend_pending())
+      continue;
+    if (processed && micros() - start >= budget)
+      return;
+    component->process_state_resend();
+    processed = true;
+    if (this->resend_failed_(component->is_state_resend_pending()))
+      return;
+    if (this->first_state_at_ == 0) {
+      this->first_state_at_ = millis() | 1;
+      ESP_LOGD(TAG, "First state published %" PRIu32 "ms after boot", this->first_state_at_);
+    }
+  }
+  for (MQTTComponent *component : this->children_) {
+    if (!component->is_discovery_resend_pending())
+      continue;
+    if (processed && micros() - start >= budget)
+      return;
+    component->process_discovery_resend();
+    processed = true;
+    if (this->resend_failed_(component->is_discovery_resend_pending()))
+      return;
+  }
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  if (this->device_discovery_pending_) {
+    if (processed && micros() - start >= budget)
+      return;
+    this->device_discovery_pending_ = !this->send_device_discovery_();
+    processed = true;
+    if (this->resend_failed_(this->device_discovery_pending_))
+      return;
+  }
+#endif
+  if (processed || this->sync_start_ == 0)
+    return;
+
+  // A full pass found nothing pending: everything scheduled at connect has been delivered
+  const uint32_t duration = millis() - this->sync_start_;
+  this->sync_start_ = 0;
+  ESP_LOGD(TAG, "Synced %u components in %" PRIu32 "ms (uptime %" PRIu32 "ms)",
+           static_cast<unsigned>(this->children_.size()), duration, millis());
+#ifdef USE_SENSOR
+  if (this->sync_duration_sensor_ != nullptr)
+    this->sync_duration_sensor_->publish_state(duration);
+#endif
+}
+
+const std::string &MQTTClientComponent::get_device_info_json() {
+  if (this->device_info_json_.empty()) {
+    // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
+    auto json = json::build_json([](JsonObject root) { build_mqtt_device_info(root); });
+    this->device_info_json_.assign(json.c_str(), json.size());
+  }
+  return this->device_info_json_;
+}
+
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+bool MQTTClientComponent::send_device_discovery_() {
+  // <prefix>/device/<node>/config, always fits: "device" is shorter than the longest component type
+  char sanitized_name[ESPHOME_DEVICE_NAME_MAX_LEN + 1];
+  str_sanitize_to(sanitized_name, App.get_name().c_str());
+  char topic[MQTT_DISCOVERY_TOPIC_MAX_LEN];
+  buf_append_printf(topic, sizeof(topic), 0, "%s/device/%s/config", this->discovery_info_.prefix.c_str(),
+                    sanitized_name);
+
+  if (this->discovery_info_.clean) {
+    // Entities announced before device mode still have their own retained configs
+    ESP_LOGV(TAG, "Cleaning device discovery");
+    return this->publish_entity_discoveries_("") && this->publish(topic, "", 0, 0, true);
+  }
+
+  // Home Assistant's migration from single-component to device discovery: flag the per-entity topics, announce
+  // the device, then clear the per-entity topics. The entities keep their IDs and history. Runs once per device;
+  // without earlier per-entity configs the publishes are empty retained messages Home Assistant ignores.
+  if (this->entity_discovery_step_ == ENTITY_DISCOVERY_MIGRATE) {
+    if (!this->publish_entity_discoveries_(R"({"migrate_discovery":true})"))
+      return false;
+    this->entity_discovery_step_ = ENTITY_DISCOVERY_ANNOUNCE;
+  }
+  if (this->entity_discovery_step_ != ENTITY_DISCOVERY_CLEAN) {
+    if (!this->publish_device_discovery_(topic))
+      return false;
+    if (this->entity_discovery_step_ == ENTITY_DISCOVERY_ANNOUNCE)
+      this->entity_discovery_step_ = ENTITY_DISCOVERY_CLEAN;
+  }
+  if (this->entity_discovery_step_ == ENTITY_DISCOVERY_CLEAN) {
+    if (!this->publish_entity_discoveries_(""))
+      return false;
+    ESP_LOGD(TAG, "Moved per-entity discovery to the device payload");
+    this->entity_discovery_step_ = ENTITY_DISCOVERY_DONE;
+    bool entity_discovery_moved = true;
+    this->entity_discovery_pref_.save(&entity_discovery_moved);
+  }
+  return true;
+}
+
+bool MQTTClientComponent::publish_entity_discoveries_(const char *payload) {
+  for (; this->entity_discovery_index_ < this->children_.size(); this->entity_discovery_index_++) {
+    MQTTComponent *component = this->children_[this->entity_discovery_index_];
+    if (component->is_discovery_enabled() && !component->publish_entity_discovery(payload))
+      return false;
+  }
+  this->entity_discovery_index_ = 0;
+  return true;
+}
+
+bool MQTTClientComponent::publish_device_discovery_(const char *topic) {
+  // A single JsonDocument with every entity takes several times the payload size in ArduinoJson's pool, more
+  // than an ESP8266 with a few dozen entities has free. Each entity gets its own small document instead: a first
+  // pass measures them, a second serializes them into one buffer of the exact size.
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
+  JsonDocument header;
+  JsonObject root = header.to<JsonObject>();
+  root[MQTT_DEVICE] = serialized(this->get_device_info_json());
+  JsonObject origin = root[MQTT_ORIGIN].to<JsonObject>();
+  origin[MQTT_DEVICE_NAME] = ESPHOME_F("ESPHome");
+  origin[MQTT_DEVICE_SW_VERSION] = ESPHOME_VERSION;
+  origin[MQTT_ORIGIN_SUPPORT_URL] = ESPHOME_F("https://esphome.io");
+  root[MQTT_COMPONENTS].to<JsonObject>();
+  // Serialized as {...,"cmps":{}}: the entities replace the trailing "{}}"
+  const size_t header_length = measureJson(header) - 3;
+
+  // Each entity document is {"<unique_id>":{...}}, its braces become the separators of the components object
+  size_t length = header_length + 2;  // Closing "}}"
+  bool empty = true;
+  for (MQTTComponent *component : this->children_) {
+    if (!component->is_discovery_enabled())
+      continue;
+    JsonDocument entity;
+    component->add_to_device_discovery(entity.to<JsonObject>());
+    length += measureJson(entity) - 1;
+    empty = false;
+  }
+  if (empty)
+    length++;  // "{}}"
+
+  RAMAllocator<char> allocator;
+  char *message = allocator.allocate(length + 1);
+  if (message == nullptr) {
+    ESP_LOGW(TAG, "Not enough memory for device discovery (%u bytes)", static_cast<unsigned>(length));
+    return false;
+  }
+  serializeJson(header, message, length + 1);
+  size_t pos = header_length;
+  for (MQTTComponent *component : this->children_) {
+    if (!component->is_discovery_enabled())
+      continue;
+    JsonDocument entity;
+    component->add_to_device_discovery(entity.to<JsonObject>());
+    const size_t written = serializeJson(entity, message + pos, length + 1 - pos);
+    if (written == 0)
+      break;
+    message[pos] = pos == header_length ? '{' : ',';
+    pos += written - 1;
+  }
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+  if (empty)
+    message[pos++] = '{';
+  if (pos + 2 != length) {
+    // An entity serialized differently between the passes, rebuild on the next loop
+    allocator.deallocate(message, length + 1);
+    return false;
+  }
+  message[pos++] = '}';
+  message[pos++] = '}';
+  message[pos] = '\0';
+
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  const uint32_t hash = mqtt_payload_hash(message, length);
+  if (hash == this->device_discovery_hash_ && this->discovery_info_.retain && this->session_present_) {
+    ESP_LOGV(TAG, "Device discovery unchanged");
+    allocator.deallocate(message, length + 1);
+    return true;
+  }
+#endif
+  ESP_LOGV(TAG, "Sending device discovery (%u bytes)", static_cast<unsigned>(length));
+  const bool sent = this->publish(topic, message, length, 0, this->discovery_info_.retain);
+  allocator.deallocate(message, length + 1);
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  if (sent && hash != this->device_discovery_hash_) {
+    this->device_discovery_hash_ = hash;
+    if (this->skip_unchanged_persist_)
+      this->device_discovery_pref_.save(&this->device_discovery_hash_);
+  }
+#endif
+  return sent;
+}
+#endif
+
 void MQTTClientComponent::loop() {
+#ifdef USE_MQTT_TELEMETRY
+  const uint32_t loop_start = micros();
+#endif
   // Call the backend loop first
   mqtt_backend_.loop();
 
@@ -370,50 +1536,82 @@ void MQTTClientComponent::loop() {
       reason_s = LOG_STR("WiFi disconnected");
     }
     ESP_LOGW(TAG, "Disconnected: %s", LOG_STR_ARG(reason_s));
+#ifdef USE_MQTT_TELEMETRY
+    this->record_disconnect_(*this->disconnect_reason_);
+#endif
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+    this->check_keep_alive_drop_(*this->disconnect_reason_ == MQTTClientDisconnectReason::TCP_DISCONNECTED);
+#endif
     this->disconnect_reason_.reset();
   }
 
   const uint32_t now = App.get_loop_component_start_time();
 
+#ifdef USE_MQTT_FAILOVER
+  if (this->failback_state_ != FAILBACK_IDLE)
+    this->check_failback_();
+#endif
+
   switch (this->state_) {
     case MQTT_CLIENT_DISABLED:
       return;  // Return to avoid a reboot when disabled
     case MQTT_CLIENT_DISCONNECTED:
-      if (now - this->connect_begin_ > 5000) {
+      if (now - this->disconnected_at_ > this->reconnect_delay_) {
         this->start_dnslookup_();
+        this->next_reconnect_delay_();
       }
       break;
     case MQTT_CLIENT_RESOLVING_ADDRESS:
+#ifdef USE_MQTT_DUAL_STACK
+      this->check_address_race_();
+#else
       this->check_dnslookup_();
+#endif
       break;
     case MQTT_CLIENT_CONNECTING:
       this->check_connected();
       break;
     case MQTT_CLIENT_CONNECTED:
       if (!this->mqtt_backend_.connected()) {
-        this->state_ = MQTT_CLIENT_DISCONNECTED;
+        this->set_disconnected_();
         ESP_LOGW(TAG, "Lost client connection");
-        this->start_dnslookup_();
+#ifdef USE_MQTT_TELEMETRY
+        this->record_disconnect_(MQTTClientDisconnectReason::TCP_DISCONNECTED);
+#endif
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+        this->check_keep_alive_drop_(true);
+#endif
+      } else if (!this->settled_ && now - this->connected_at_ < MQTT_CONNECT_SETTLE_TIME) {
+        this->last_connected_ = now;
       } else {
+        if (!this->settled_) {
+          this->settled_ = true;
+#ifndef USE_MQTT_BURST
+          this->send_device_info_();
+#endif
+        }
         if (!this->birth_message_.topic.empty() && !this->sent_birth_message_) {
           this->sent_birth_message_ = this->publish(this->birth_message_);
         }
+#ifdef USE_MQTT_LOG_BUFFER
+        if (this->log_buffer_size_ > 0)
+          this->flush_log_buffer_(now);
+#endif
 
         this->last_connected_ = now;
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+        if (this->keep_alive_stable_at_ != 0 &&
+            now - this->keep_alive_stable_at_ > MQTT_KEEPALIVE_STABLE_INTERVALS * this->keep_alive_ * 1000) {
+          this->keep_alive_stable_at_ = now;
+          this->adapt_keep_alive_(true);
+        }
+#endif
         this->resubscribe_subscriptions_();
 
-        // Process pending resends for all MQTT components centrally
-        // Limit work per loop iteration to avoid triggering task WDT on reconnect
-        {
-          uint8_t resend_count = 0;
-          for (MQTTComponent *component : this->children_) {
-            if (component->is_resend_pending()) {
-              component->process_resend();
-              if (++resend_count >= MAX_RESENDS_PER_LOOP)
-                break;
-            }
-          }
-        }
+        this->process_resends_();
+#ifdef USE_MQTT_BURST
+        this->check_burst_complete_();
+#endif
       }
       break;
   }
@@ -422,6 +1620,9 @@ void MQTTClientComponent::loop() {
     ESP_LOGE(TAG, "Can't connect; restarting");
     App.reboot();
   }
+#ifdef USE_MQTT_TELEMETRY
+  this->loop_time_histogram_.record(micros() - loop_start);
+#endif
 }
 float MQTTClientComponent::get_setup_priority() const { return setup_priority::AFTER_WIFI; }
 
@@ -436,7 +1637,7 @@ bool MQTTClientComponent::subscribe_(const char *topic, uint8_t qos) {
   if (ret) {
     ESP_LOGV(TAG, "subscribe(topic='%s')", topic);
   } else {
-    delay(5);
+    // resubscribe_subscriptions_() retries after a second
     ESP_LOGV(TAG, "Subscribe failed for topic='%s'. Will retry", topic);
     this->status_momentary_warning("subscribe", 1000);
   }
@@ -473,21 +1674,31 @@ void MQTTClientComponent::subscribe(const std::string &topic, mqtt_callback_t ca
 }
 
 void MQTTClientComponent::subscribe_json(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos) {
+#ifdef USE_MQTT_MSGPACK
+  auto f = [callback](const std::string &topic, const std::string &payload) {
+    JsonDocument doc;
+    DeserializationError err = deserializeMsgPack(doc, payload);
+    if (err || !doc.is<JsonObject>()) {
+      ESP_LOGW(TAG, "Invalid MessagePack payload on '%s': %s", topic.c_str(), err.c_str());
+      return;
+    }
+    callback(topic, doc.as<JsonObject>());
+  };
+  this->subscribe(topic, f, qos);
+#else
+  this->subscribe_json_text(topic, callback, qos);
+#endif
+}
+
+void MQTTClientComponent::subscribe_json_text(const std::string &topic, const mqtt_json_callback_t &callback,
+                                              uint8_t qos) {
   auto f = [callback](const std::string &topic, const std::string &payload) {
     json::parse_json(payload, [topic, callback](JsonObject root) -> bool {
       callback(topic, root);
       return true;
     });
   };
-  MQTTSubscription subscription{
-      .topic = topic,
-      .qos = qos,
-      .callback = f,
-      .subscribed = false,
-      .resubscribe_timeout = 0,
-  };
-  this->resubscribe_subscription_(&subscription);
-  this->subscriptions_.push_back(subscription);
+  this->subscribe(topic, f, qos);
 }
 
 void MQTTClientComponent::unsubscribe(const std::string &topic) {
@@ -496,9 +1707,13 @@ void MQTTClientComponent::unsubscribe(const std::string &topic) {
   if (ret) {
     ESP_LOGV(TAG, "unsubscribe(topic='%s')", topic.c_str());
   } else {
-    delay(5);
-    ESP_LOGV(TAG, "Unsubscribe failed for topic='%s'.", topic.c_str());
+    ESP_LOGV(TAG, "Unsubscribe failed for topic='%s'. Will retry", topic.c_str());
     this->status_momentary_warning("unsubscribe", 1000);
+    // Try once more later instead of stalling the loop; a reconnect drops the subscription anyway
+    this->set_timeout(1000, [this, topic]() {
+      if (this->is_connected())
+        this->mqtt_backend_.unsubscribe(topic.c_str());
+    });
   }
 
   auto it = subscriptions_.begin();
@@ -535,30 +1750,89 @@ bool MQTTClientComponent::publish(const char *topic, const char *payload, size_t
   if (!this->is_connected()) {
     return false;
   }
-  size_t topic_len = strlen(topic);
-  bool logging_topic = (topic_len == this->log_message_.topic.size()) &&
-                       (memcmp(this->log_message_.topic.c_str(), topic, topic_len) == 0);
+  // Logged below as passed in, not as the compressed bytes
+  [[maybe_unused]] const char *plain_payload = payload;
+  [[maybe_unused]] const size_t plain_length = payload_length;
+#ifdef USE_MQTT_COMPRESSION
+  std::string compressed_topic;
+  this->compress_payload_(topic, payload, payload_length, compressed_topic, this->compression_buffer_,
+                          this->compression_buffer_size_);
+#endif
+  // No blocking retry here: a full send buffer only drains once the loop continues. Component state that
+  // failed to publish is flagged and resent by process_resends_().
   bool ret = this->mqtt_backend_.publish(topic, payload, payload_length, qos, retain);
-  delay(0);
-  if (!ret && !logging_topic && this->is_connected()) {
-    delay(0);
-    ret = this->mqtt_backend_.publish(topic, payload, payload_length, qos, retain);
-    delay(0);
-  }
+#ifdef USE_MQTT_BURST
+  if (ret && qos > 0)
+    this->inflight_++;
+#endif
 
-  if (!logging_topic) {
-    if (ret) {
-      ESP_LOGV(TAG, "Publish(topic='%s' retain=%d qos=%d)", topic, retain, qos);
-      ESP_LOGVV(TAG, "Publish payload (len=%u): '%.*s'", payload_length, static_cast<int>(payload_length), payload);
-    } else {
-      ESP_LOGV(TAG, "Publish failed for topic='%s' (len=%u). Will retry", topic, payload_length);
-      this->status_momentary_warning("publish", 1000);
-    }
+  if (ret) {
+    ESP_LOGV(TAG, "Publish(topic='%s' retain=%d qos=%d)", topic, retain, qos);
+    ESP_LOGVV(TAG, "Publish payload (len=%u): '%.*s'", plain_length, static_cast<int>(plain_length), plain_payload);
+  } else {
+    ESP_LOGV(TAG, "Publish failed for topic='%s' (len=%u). Will retry", topic, payload_length);
+    this->status_momentary_warning("publish", 1000);
   }
   return ret != 0;
 }
 
+bool MQTTClientComponent::publish_log_(const char *topic, const char *payload, size_t payload_length) {
+  // Called from the log path: no retry and no logging of its own, which would recurse into on_log()
+  if (!this->is_connected())
+    return false;
+#ifdef USE_MQTT_COMPRESSION
+  std::string compressed_topic;
+  this->compress_payload_(topic, payload, payload_length, compressed_topic, this->log_compression_buffer_,
+                          this->log_compression_buffer_size_);
+#endif
+  bool ret = this->mqtt_backend_.publish(topic, payload, payload_length, this->log_message_.qos,
+                                         this->log_message_.retain);
+#ifdef USE_MQTT_BURST
+  if (ret && this->log_message_.qos > 0)
+    this->inflight_++;
+#endif
+  return ret;
+}
+
+#ifdef USE_MQTT_COMPRESSION
+void MQTTClientComponent::compress_payload_(const char *&topic, const char *&payload, size_t &payload_length,
+                                            std::string &compressed_topic, std::unique_ptr<uint8_t[]> &buffer,
+                                            size_t &buffer_size) {
+  if (payload_length < this->compression_min_size_ || payload_length > this->compression_max_size_ ||
+      !this->is_compressed_topic_(topic))
+    return;
+  // Only keep the compressed form if it is strictly smaller than the original
+  if (buffer_size < payload_length) {
+    buffer = make_unique<uint8_t[]>(payload_length);
+    buffer_size = payload_length;
+  }
+  size_t compressed_length =
+      heatshrink_compress(reinterpret_cast<const uint8_t *>(payload), payload_length, buffer.get(),
+                          payload_length - 1, this->compression_window_bits_, this->compression_lookahead_bits_);
+  if (compressed_length == 0)
+    return;
+  compressed_topic.reserve(strlen(topic) + strlen(this->compression_topic_suffix_));
+  compressed_topic.append(topic).append(this->compression_topic_suffix_);
+  topic = compressed_topic.c_str();
+  payload = reinterpret_cast<const char *>(buffer.get());
+  payload_length = compressed_length;
+}
+#endif
+
 bool MQTTClientComponent::publish_json(const char *topic, const json::json_build_t &f, uint8_t qos, bool retain) {
+#ifdef USE_MQTT_MSGPACK
+  JsonDocument doc;
+  f(doc.to<JsonObject>());
+  std::string message;
+  serializeMsgPack(doc, message);
+  return this->publish(topic, message.data(), message.size(), qos, retain);
+#else
+  return this->publish_json_text(topic, f, qos, retain);
+#endif
+}
+
+bool MQTTClientComponent::publish_json_text(const char *topic, const json::json_build_t &f, uint8_t qos,
+                                            bool retain) {
   auto message = json::build_json(f);
   return this->publish(topic, message.c_str(), message.size(), qos, retain);
 }
@@ -637,6 +1911,16 @@ static bool topic_match(const char *message, const char *subscription) {
   return topic_match(message, subscription, *message != '\0' && *message != '$', false);
 }
 
+#ifdef USE_MQTT_COMPRESSION
+bool MQTTClientComponent::is_compressed_topic_(const char *topic) const {
+  for (const char *filter : this->compressed_topics_) {
+    if (topic_match(topic, filter))
+      return true;
+  }
+  return false;
+}
+#endif
+
 void MQTTClientComponent::on_message(const std::string &topic, const std::string &payload) {
 #ifdef USE_ESP8266
   // IMPORTANT: This defer is REQUIRED to prevent stack overflow crashes on ESP8266.
@@ -673,8 +1957,22 @@ void MQTTClientComponent::disable_log_message() { this->log_message_.topic = "";
 bool MQTTClientComponent::is_log_message_enabled() const { return !this->log_message_.topic.empty(); }
 void MQTTClientComponent::set_reboot_timeout(uint32_t reboot_timeout) { this->reboot_timeout_ = reboot_timeout; }
 void MQTTClientComponent::register_mqtt_component(MQTTComponent *component) { this->children_.push_back(component); }
-void MQTTClientComponent::set_log_level(int level) { this->log_level_ = level; }
-void MQTTClientComponent::set_keep_alive(uint16_t keep_alive_s) { this->mqtt_backend_.set_keep_alive(keep_alive_s); }
+void MQTTClientComponent::set_log_level(int level) {
+  this->log_level_ = level;
+#ifdef USE_MQTT_LOG_ROUTES
+  this->log_max_level_ = level;
+  for (const auto &route : this->log_routes_) {
+    if (route.level > this->log_max_level_)
+      this->log_max_level_ = route.level;
+  }
+#endif
+}
+void MQTTClientComponent::set_keep_alive(uint16_t keep_alive_s) {
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  this->keep_alive_ = keep_alive_s;
+#endif
+  this->mqtt_backend_.set_keep_alive(keep_alive_s);
+}
 void MQTTClientComponent::set_log_message_template(MQTTMessage &&message) { this->log_message_ = std::move(message); }
 const MQTTDiscoveryInfo &MQTTClientComponent::get_discovery_info() const { return this->discovery_info_; }
 void MQTTClientComponent::set_topic_prefix(const std::string &topic_prefix, const std::string &check_topic_prefix) {
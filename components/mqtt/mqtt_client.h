@@ -10,9 +10,13 @@
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
 #ifdef USE_LOGGER
 #include "esphome/components/logger/logger.h"
 #endif
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
 #if defined(USE_ESP32)
 #include "mqtt_backend_esp32.h"
 #elif defined(USE_ESP8266)
@@ -25,6 +29,9 @@
 #include "lwip/ip_addr.h"
 
 #include <vector>
+#include "mqtt_address_race.h"
+#include "mqtt_histogram.h"
+#include "mqtt_tcp_probe.h"
 
 namespace esphome::mqtt {
 
@@ -59,6 +66,16 @@ struct MQTTCredentials {
   bool clean_session;     ///< Whether the session will be cleaned or remembered between connects.
 };
 
+#ifdef USE_MQTT_FAILOVER
+/// A broker in the failover list, index 0 is the configured (primary) broker.
+struct MQTTBroker {
+  std::string address;
+  uint16_t port;
+  std::string username;
+  std::string password;
+};
+#endif
+
 /// Simple data struct for Home Assistant component availability.
 struct Availability {
   std::string topic;  ///< Empty means disabled
@@ -101,6 +118,23 @@ enum MQTTClientState {
 
 class MQTTComponent;
 
+#ifdef USE_MQTT_DNS_CACHE
+/// Last good broker address, persisted so a cold boot can connect before DNS answers.
+struct MQTTBrokerAddressCache {
+  uint32_t address_hash;  ///< Hash of the configured host and port the address belongs to
+  ip_addr_t ip;
+};
+#endif
+
+#ifdef USE_MQTT_LOG_ROUTES
+/// Log routing rule for the MQTT log topic.
+struct MQTTLogRoute {
+  const char *tag_pattern;  ///< Exact tag, or a tag prefix when it ends in '*'
+  const char *topic;        ///< Topic for matching lines, nullptr uses the log topic
+  uint8_t level;            ///< Most verbose level published for matching tags
+};
+#endif
+
 class MQTTClientComponent final : public Component {
  public:
   MQTTClientComponent();
@@ -120,6 +154,23 @@ class MQTTClientComponent final : public Component {
 
   /// Set the keep alive time in seconds, every 0.7*keep_alive a ping will be sent.
   void set_keep_alive(uint16_t keep_alive_s);
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  /** Let the keep alive adapt to the link, starting from the value given to set_keep_alive().
+   *
+   * It doubles after a connection stayed up for a number of keep alive intervals. It halves after two
+   * consecutive drops that look like an idle timeout on the path: the network stayed up, and the connection
+   * lived and received nothing for at least one keep alive interval. The result is saved and used from the
+   * next CONNECT on.
+   *
+   * How often pings go out depends on the backend: AsyncMqttClient only pings after a keep alive interval
+   * without outbound packets, so regular publishes replace them. esp-mqtt pings on a fixed timer regardless
+   * of traffic.
+   */
+  void set_adaptive_keep_alive(uint16_t min_s, uint16_t max_s) {
+    this->keep_alive_min_ = min_s;
+    this->keep_alive_max_ = max_s;
+  }
+#endif
 
   /** Set the Home Assistant discovery info
    *
@@ -138,6 +189,35 @@ class MQTTClientComponent final : public Component {
   void disable_discovery();
   bool is_discovery_enabled() const;
   bool is_discovery_ip_enabled() const;
+  /** Spread responses to fleet-wide triggers (esphome/discover, esphome/ping, Home Assistant birth).
+   *
+   * Each node answers after a fixed offset within the window, derived from its MAC address.
+   */
+  void set_discovery_jitter(uint32_t discovery_jitter) { this->discovery_jitter_ = discovery_jitter; }
+  /// Resend discovery and state when Home Assistant publishes "online" to <discovery prefix>/status.
+  void set_rediscover_on_ha_birth(bool rediscover) { this->rediscover_on_ha_birth_ = rediscover; }
+  /** Get the discovery device block as serialized JSON.
+   *
+   * Nothing in it changes at runtime, so it is rendered once and spliced into every discovery payload.
+   */
+  const std::string &get_device_info_json();
+
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  /** Skip republishing retained discovery and state payloads the broker already holds.
+   *
+   * Only takes effect when the broker resumed our session, otherwise it may have lost its retained messages.
+   * @param persist Also keep the discovery payload hashes in flash so they survive a reboot.
+   */
+  void set_skip_unchanged(bool persist) { this->skip_unchanged_persist_ = persist; }
+  bool is_skip_unchanged_persisted() const { return this->skip_unchanged_persist_; }
+  /// Whether the broker reported a resumed session on the last CONNACK.
+  bool is_session_present() const { return this->session_present_; }
+#endif
+
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  /// Have the single device-based discovery payload rebuilt and published from loop().
+  void schedule_device_discovery() { this->device_discovery_pending_ = true; }
+#endif
 
 #ifdef USE_ESP32
   void set_ca_certificate(const char *cert) { this->mqtt_backend_.set_ca_certificate(cert); }
@@ -162,6 +242,25 @@ class MQTTClientComponent final : public Component {
   /// Manually set the topic used for logging.
   void set_log_message_template(MQTTMessage &&message);
   void set_log_level(int level);
+#ifdef USE_MQTT_LOG_ROUTES
+  /** Route log lines whose tag matches tag_pattern by level, and optionally to their own topic.
+   *
+   * Routes are checked in the order they were added and the first match wins. Tags without a route use
+   * the log topic and log level.
+   */
+  void add_log_route(const char *tag_pattern, uint8_t level, const char *topic = nullptr);
+#endif
+#ifdef USE_MQTT_LOG_BUFFER
+  /** Buffer log lines and publish them from loop() instead of from the logger callback.
+   *
+   * @param buffer_size Byte budget for buffered lines, lines that do not fit are counted and reported as dropped.
+   * @param flush_interval Minimum time in milliseconds between two log PUBLISHes.
+   */
+  void set_log_buffer(size_t buffer_size, uint32_t flush_interval) {
+    this->log_buffer_size_ = buffer_size;
+    this->log_flush_interval_ = flush_interval;
+  }
+#endif
   /// Get the topic used for logging. Defaults to "<topic_prefix>/debug" and the value is cached for speed.
   void disable_log_message();
   bool is_log_message_enabled() const;
@@ -176,7 +275,8 @@ class MQTTClientComponent final : public Component {
 
   /** Subscribe to a MQTT topic and automatically parse JSON payload.
    *
-   * If an invalid JSON payload is received, the callback will not be called.
+   * If an invalid JSON payload is received, the callback will not be called. The payload is parsed as
+   * MessagePack instead when payload_format is msgpack (USE_MQTT_MSGPACK).
    *
    * @param topic The topic. Wildcards are currently not supported.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
@@ -185,6 +285,9 @@ class MQTTClientComponent final : public Component {
    */
   void subscribe_json(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos = 0);
 
+  /// Subscribe to a MQTT topic and parse the payload as JSON text, regardless of the configured payload format.
+  void subscribe_json_text(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos = 0);
+
   /** Unsubscribe from an MQTT topic.
    *
    * If multiple existing subscriptions to the same topic exist, all of them will be removed.
@@ -215,6 +318,8 @@ class MQTTClientComponent final : public Component {
   bool publish(const char *topic, const char *payload, size_t payload_length, uint8_t qos = 0, bool retain = false);
 
   /** Construct and send a JSON MQTT message.
+   *
+   * The payload is MessagePack instead of JSON text when payload_format is msgpack (USE_MQTT_MSGPACK).
    *
    * @param topic The topic.
    * @param f The Json Message builder.
@@ -225,6 +330,13 @@ class MQTTClientComponent final : public Component {
   /// Publish JSON directly without heap allocation for topic
   bool publish_json(const char *topic, const json::json_build_t &f, uint8_t qos = 0, bool retain = false);
 
+  /** Construct and send a JSON MQTT message as text, regardless of the configured payload format.
+   *
+   * Used for Home Assistant discovery, device info and the state of discovered entities, which must stay JSON
+   * when payload_format is msgpack.
+   */
+  bool publish_json_text(const char *topic, const json::json_build_t &f, uint8_t qos = 0, bool retain = false);
+
   /// Setup the MQTT client, registering a bunch of callbacks and attempting to connect.
   void setup() override;
   void dump_config() override;
@@ -245,6 +357,61 @@ class MQTTClientComponent final : public Component {
 
   void set_reboot_timeout(uint32_t reboot_timeout);
 
+  /// Give up on a connection attempt that got no CONNACK after this many milliseconds.
+  void set_connect_timeout(uint32_t connect_timeout) { this->connect_timeout_ = connect_timeout; }
+
+#ifdef USE_MQTT_FAILOVER
+  /// Append a broker to fail over to when the current one keeps failing.
+  void add_failover_broker(const std::string &address, uint16_t port, const std::string &username,
+                           const std::string &password) {
+    this->brokers_.push_back(MQTTBroker{address, port, username, password});
+  }
+  /** Configure broker failover.
+   *
+   * @param attempts Failed connection attempts before moving on to the next broker. The client also moves on once
+   * connect_timeout has passed since the first failed attempt, whatever the count.
+   * @param failback_interval How often to try the primary broker again while on another one, 0 to never.
+   */
+  void set_failover(uint8_t attempts, uint32_t failback_interval) {
+    this->failover_attempts_ = attempts;
+    this->failback_interval_ = failback_interval;
+  }
+#endif
+
+#ifdef USE_MQTT_DUAL_STACK
+  /// Start the handshake over the other address family this many milliseconds after the preferred one.
+  void set_family_fallback_timeout(uint32_t timeout) { this->family_fallback_timeout_ = timeout; }
+#endif
+
+#ifdef USE_MQTT_DNS_CACHE
+  /** Connect to the last good broker address without waiting for DNS.
+   *
+   * The address is persisted across reboots. Once it is older than ttl it is re-resolved in the background
+   * while connecting to the cached one, a failed connection drops it and falls back to a fresh lookup.
+   */
+  void set_dns_cache_ttl(uint32_t ttl) { this->dns_cache_ttl_ = ttl; }
+#endif
+
+  /** Set the reconnect backoff policy.
+   *
+   * The wait between connection attempts starts at initial and is multiplied after every attempt, up to max.
+   * With full jitter each wait is drawn uniformly from [0, current backoff]. A CONNACK resets the backoff.
+   */
+  void set_reconnect_backoff(uint32_t initial, float multiplier, uint32_t max, bool jitter) {
+    this->backoff_initial_ = initial;
+    this->backoff_multiplier_ = multiplier;
+    this->backoff_max_ = max;
+    this->backoff_jitter_ = jitter;
+    this->backoff_ = initial;
+    this->reconnect_delay_ = initial;
+  }
+#ifdef USE_SENSOR
+  /// Diagnostic sensor reporting the wait before the next reconnect attempt.
+  void set_reconnect_backoff_sensor(sensor::Sensor *reconnect_backoff_sensor) {
+    this->reconnect_backoff_sensor_ = reconnect_backoff_sensor;
+  }
+#endif
+
   void register_mqtt_component(MQTTComponent *component);
 
   bool is_connected();
@@ -269,12 +436,103 @@ class MQTTClientComponent final : public Component {
 
   void set_wait_for_connection(bool wait_for_connection) { this->wait_for_connection_ = wait_for_connection; }
 
+  /// Set the time budget in microseconds for discovery/state resends per loop iteration.
+  void set_resend_budget(uint32_t resend_budget_us) { this->resend_budget_us_ = resend_budget_us; }
+#ifdef USE_SENSOR
+  /// Diagnostic sensor reporting the time from CONNACK until all components have resent discovery and state.
+  void set_sync_duration_sensor(sensor::Sensor *sync_duration_sensor) {
+    this->sync_duration_sensor_ = sync_duration_sensor;
+  }
+  /// Diagnostic sensor reporting the time from opening the connection until CONNACK, including any TLS handshake.
+  void set_connect_duration_sensor(sensor::Sensor *connect_duration_sensor) {
+    this->connect_duration_sensor_ = connect_duration_sensor;
+  }
+#endif
+
+#ifdef USE_MQTT_TELEMETRY
+#ifdef USE_SENSOR
+  void set_dns_time_sensor(sensor::Sensor *dns_time_sensor) { this->dns_time_sensor_ = dns_time_sensor; }
+  void set_reconnects_sensor(sensor::Sensor *reconnects_sensor) { this->reconnects_sensor_ = reconnects_sensor; }
+  void set_disconnects_sensor(sensor::Sensor *disconnects_sensor) { this->disconnects_sensor_ = disconnects_sensor; }
+  void set_connected_time_sensor(sensor::Sensor *connected_time_sensor) {
+    this->connected_time_sensor_ = connected_time_sensor;
+  }
+#endif
+  /// Total time connected to a broker since boot, in seconds.
+  uint32_t get_connected_time() const;
+#endif
+
+#ifdef USE_MQTT_LATENCY_PROBE
+  /** Measure the round trip through the broker by publishing to a topic this node subscribes to.
+   *
+   * @param interval Time between probes in milliseconds. A probe not echoed before the next one counts as lost.
+   * @param qos QoS used for both the probe and the subscription.
+   */
+  void set_latency_probe(uint32_t interval, uint8_t qos) {
+    this->latency_probe_interval_ = interval;
+    this->latency_probe_qos_ = qos;
+  }
+#ifdef USE_SENSOR
+  void set_latency_p50_sensor(sensor::Sensor *latency_p50_sensor) { this->latency_p50_sensor_ = latency_p50_sensor; }
+  void set_latency_p95_sensor(sensor::Sensor *latency_p95_sensor) { this->latency_p95_sensor_ = latency_p95_sensor; }
+  void set_latency_max_sensor(sensor::Sensor *latency_max_sensor) { this->latency_max_sensor_ = latency_max_sensor; }
+#endif
+#endif
+
+#ifdef USE_MQTT_BURST
+  /** Called once per boot when the first sync is done, every entity has published a state and every QoS>0
+   * publish was acknowledged. An entity that never gets a state holds this back, so pair it with a timeout.
+   */
+  void add_on_burst_complete_callback(std::function<void(uint32_t)> &&callback) {
+    this->on_burst_complete_.add(std::move(callback));
+  }
+#endif
+
+#ifdef USE_MQTT_COMPRESSION
+  /** Configure heatshrink compression for payloads published to topics added with add_compressed_topic().
+   *
+   * A compressed payload is published to `<topic><topic_suffix>`. Payloads shorter than min_size, longer than
+   * max_size (which bounds the time spent compressing inside publish()), or that would not shrink, are
+   * published unchanged to the original topic.
+   */
+  void set_compression(uint8_t window_bits, uint8_t lookahead_bits, size_t min_size, size_t max_size,
+                       const char *topic_suffix) {
+    this->compression_window_bits_ = window_bits;
+    this->compression_lookahead_bits_ = lookahead_bits;
+    this->compression_min_size_ = min_size;
+    this->compression_max_size_ = max_size;
+    this->compression_topic_suffix_ = topic_suffix;
+  }
+  /// Compress payloads published to topics matching this filter (MQTT wildcards allowed).
+  void add_compressed_topic(const char *topic_filter) { this->compressed_topics_.push_back(topic_filter); }
+#endif
+
  protected:
+  /// Answer a discover/ping request after this node's jitter offset.
+  void schedule_device_info_();
+  /// Render the esphome/discover payload into device_info_payload_.
+  void build_device_info_payload_();
+  /// Schedule discovery and state of every component to be resent.
+  void rediscover_();
   void send_device_info_();
 
   /// Reconnect to the MQTT broker if not already connected.
   void start_connect_();
   void start_dnslookup_();
+  void resolve_broker_();
+#ifdef USE_MQTT_DUAL_STACK
+  /// Resolve both address families and race their handshakes, see MQTTAddressRace.
+  void start_address_race_();
+  void check_address_race_();
+  /// Give up on the race, reporting reason like a failed connection.
+  void fail_address_race_(MQTTClientDisconnectReason reason);
+  void on_family_resolved_(uint8_t family, const ip_addr_t *ipaddr);
+  static void dns_found_ipv6_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg);
+  static void dns_found_ipv4_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg);
+#endif
+#ifdef USE_MQTT_TELEMETRY
+  void record_dns_time_(uint32_t dns_time);
+#endif
   void check_dnslookup_();
 #if defined(USE_ESP8266) && LWIP_VERSION_MAJOR == 1
   static void dns_found_callback(const char *name, ip_addr_t *ipaddr, void *callback_arg);
@@ -285,6 +543,79 @@ class MQTTClientComponent final : public Component {
   /// Re-calculate the availability property.
   void recalculate_availability_();
 
+  /// Run pending component resends within resend_budget_us_.
+  void process_resends_();
+  /// Grow the resend backoff after a failed resend and return true, reset it after a successful one.
+  bool resend_failed_(bool failed);
+#ifdef USE_MQTT_BURST
+  /// Trust the subscriptions held by a present session if the subscribed topics did not change.
+  void restore_subscriptions_();
+  void check_burst_complete_();
+#endif
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  void adapt_keep_alive_(bool stable);
+  /// Called once per dropped connection, narrows the keep alive after repeated idle timeouts.
+  void check_keep_alive_drop_(bool tcp_drop);
+#endif
+#ifdef USE_MQTT_TELEMETRY
+  void record_disconnect_(MQTTClientDisconnectReason reason);
+  /// Move the whole seconds of the current connection into connected_s_.
+  void fold_connected_time_();
+#endif
+#ifdef USE_MQTT_LATENCY_PROBE
+  void send_latency_probe_();
+  void on_latency_probe_(const std::string &payload);
+#endif
+#ifdef USE_MQTT_FAILOVER
+  /// Make brokers_[index] the broker used for the next connection attempt.
+  void select_broker_(uint8_t index);
+  /// Called when a connection attempt did not reach CONNACK.
+  void on_connect_failed_();
+  /// Check with a side TCP connection whether the primary broker is back, the session stays up meanwhile.
+  void probe_primary_();
+  /// Advance the primary probe, switch back to the primary once it accepted a connection.
+  void check_failback_();
+#if defined(USE_ESP8266) && LWIP_VERSION_MAJOR == 1
+  static void failback_dns_callback(const char *name, ip_addr_t *ipaddr, void *callback_arg);
+#else
+  static void failback_dns_callback(const char *name, const ip_addr_t *ipaddr, void *callback_arg);
+#endif
+#endif
+#ifdef USE_MQTT_DNS_CACHE
+  /// Forget the cached broker address after a failed connection attempt to it.
+  void drop_cached_ip_();
+#endif
+  /// Draw the wait before the next reconnect attempt and grow the backoff.
+  void next_reconnect_delay_();
+  /// Enter MQTT_CLIENT_DISCONNECTED, loop() starts the next attempt reconnect_delay_ from now.
+  void set_disconnected_();
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  /// Publish one Home Assistant device-based discovery payload announcing all registered components.
+  bool send_device_discovery_();
+  /// Serialize and publish the device payload, one entity at a time.
+  bool publish_device_discovery_(const char *topic);
+  /// Publish payload on the per-entity discovery topic of every child, resuming where a failed publish stopped.
+  bool publish_entity_discoveries_(const char *payload);
+#endif
+
+  /// Publish a log payload without retries or logging.
+  bool publish_log_(const char *topic, const char *payload, size_t payload_length);
+#ifdef USE_MQTT_LOG_ROUTES
+  const MQTTLogRoute *find_log_route_(const char *tag);
+  int16_t match_log_route_(const char *tag) const;
+#endif
+#ifdef USE_MQTT_LOG_BUFFER
+  void buffer_log_line_(const char *topic, const char *message, size_t message_len);
+  void flush_log_buffer_(uint32_t now);
+#endif
+
+#ifdef USE_MQTT_COMPRESSION
+  bool is_compressed_topic_(const char *topic) const;
+  /// Swap topic/payload for the compressed form, written to buffer, if the topic is flagged and the payload shrinks.
+  void compress_payload_(const char *&topic, const char *&payload, size_t &payload_length,
+                         std::string &compressed_topic, std::unique_ptr<uint8_t[]> &buffer, size_t &buffer_size);
+#endif
+
   bool subscribe_(const char *topic, uint8_t qos);
   void resubscribe_subscription_(MQTTSubscription *sub);
   void resubscribe_subscriptions_();
@@ -311,9 +642,42 @@ class MQTTClientComponent final : public Component {
       .object_id_generator = MQTT_NONE_OBJECT_ID_GENERATOR,
   };
   std::string topic_prefix_{};
+  std::string device_info_json_;  ///< Cache for get_device_info_json(), empty until first used
+  std::string device_info_payload_;  ///< Cached esphome/discover payload, see send_device_info_()
+  uint32_t device_info_fingerprint_{0};
+  uint32_t discovery_jitter_{0};
+  uint32_t jitter_offset_{0};  ///< This node's offset within discovery_jitter_, fixed at setup
+  bool device_info_scheduled_{false};
+  bool rediscover_on_ha_birth_{false};
   MQTTMessage log_message_;
   std::string payload_buffer_;
   int log_level_{ESPHOME_LOG_LEVEL};
+#ifdef USE_MQTT_LOG_ROUTES
+  static constexpr size_t LOG_ROUTE_CACHE_SIZE = 32;
+  struct LogRouteCacheEntry {
+    const char *tag;
+    int16_t route;  ///< Index into log_routes_, -1 when no route matches
+  };
+  std::vector<MQTTLogRoute> log_routes_;
+  LogRouteCacheEntry log_route_cache_[LOG_ROUTE_CACHE_SIZE]{};
+  int log_max_level_{ESPHOME_LOG_LEVEL};
+#endif
+#ifdef USE_MQTT_LOG_BUFFER
+  /// Runs of lines for one topic in the log buffer, the last one is kept for the dropped lines marker
+  static constexpr uint8_t LOG_BUFFER_MAX_RUNS = 8;
+  struct LogBufferRun {
+    size_t start;       ///< Offset of the run's first line in log_buffer_
+    const char *topic;  ///< Topic of a log route, nullptr for the log topic
+  };
+  std::unique_ptr<char[]> log_buffer_;
+  size_t log_buffer_size_{0};
+  size_t log_buffer_len_{0};
+  LogBufferRun log_runs_[LOG_BUFFER_MAX_RUNS]{};
+  uint8_t log_run_count_{0};
+  uint32_t log_flush_interval_{0};
+  uint32_t last_log_flush_{0};
+  uint32_t log_dropped_lines_{0};
+#endif
 
   std::vector<MQTTSubscription> subscriptions_;
 #if defined(USE_ESP32)
@@ -330,16 +694,173 @@ class MQTTClientComponent final : public Component {
   network::IPAddress ip_;
   bool dns_resolved_{false};
   bool dns_resolve_error_{false};
+  bool dns_pending_{false};  ///< A lookup of credentials_.address is in flight, dns_found_callback() takes its answer
+#ifdef USE_MQTT_DNS_CACHE
+  bool ip_cached_{false};           ///< ip_ holds a known good broker address to connect to without a lookup
+  bool connect_from_cache_{false};  ///< The current connection attempt uses the cached address
+  bool connected_once_{false};
+  uint32_t dns_cache_ttl_{0};
+  uint32_t resolved_at_{0};  ///< millis() of the last lookup of the cached address
+  ESPPreferenceObject broker_pref_;
+#endif
+#if defined(USE_MQTT_DNS_CACHE) || defined(USE_MQTT_DUAL_STACK)
+  network::IPAddress connect_ip_;  ///< Address of the current attempt, ip_ may be refreshed meanwhile
+#endif
   bool enable_on_boot_{true};
   std::vector<MQTTComponent *> children_;
   uint32_t reboot_timeout_{300000};
+  // Reconnect backoff, the defaults retry every 5s
+  uint32_t backoff_initial_{5000};
+  uint32_t backoff_max_{5000};
+  uint32_t backoff_{5000};          ///< Current upper bound of the wait
+  uint32_t reconnect_delay_{5000};  ///< Wait before the next attempt, measured from disconnected_at_
+  float backoff_multiplier_{1.0f};
+  bool backoff_jitter_{false};
+#ifdef USE_SENSOR
+  sensor::Sensor *reconnect_backoff_sensor_{nullptr};
+#endif
   uint32_t connect_begin_;
+  uint32_t disconnected_at_{0};
+  uint32_t connect_timeout_{60000};
+#ifdef USE_MQTT_DUAL_STACK
+  uint32_t family_fallback_timeout_{3000};
+  bool ipv6_first_{true};  ///< Family preferred in the race, the one of the last CONNACK
+  enum FamilyDnsState : uint8_t {
+    FAMILY_DNS_PENDING,
+    FAMILY_DNS_RESOLVED,
+    FAMILY_DNS_FAILED,
+    FAMILY_DNS_REPORTED,  ///< Result handed to address_race_
+  };
+  MQTTAddressRace address_race_;
+  // Indexed by MQTTAddressRace::Family
+  MQTTTcpProbe family_probes_[2];
+  network::IPAddress family_ips_[2];
+  FamilyDnsState family_dns_[2]{FAMILY_DNS_REPORTED, FAMILY_DNS_REPORTED};  ///< Written by the DNS callbacks
+  ESPPreferenceObject family_pref_;
+#endif
+#ifdef USE_MQTT_ADAPTIVE_KEEPALIVE
+  uint16_t keep_alive_{15};  ///< Sent with the next CONNECT
+  uint16_t keep_alive_min_{15};
+  uint16_t keep_alive_max_{15};
+  uint16_t connection_keep_alive_{15};  ///< Keep alive sent in the CONNECT of the current connection
+  uint32_t keep_alive_stable_at_{0};    ///< millis() since the connection counts as stable, 0 while disconnected
+  uint32_t last_rx_{0};                 ///< millis() of the last incoming PUBLISH or CONNACK
+  uint8_t keep_alive_timeouts_{0};      ///< Consecutive drops that looked like an idle timeout
+  ESPPreferenceObject keep_alive_pref_;
+#endif
+#ifdef USE_MQTT_FAILOVER
+  std::vector<MQTTBroker> brokers_;
+  uint32_t failback_interval_{0};
+  uint8_t broker_index_{0};
+  uint8_t healthy_index_{0};  ///< Broker of the last CONNACK, persisted
+  uint8_t failed_attempts_{0};
+  uint8_t failover_attempts_{3};
+  bool attempt_pending_{false};  ///< A connection attempt was started and has not reached CONNACK yet
+  bool probing_primary_{false};  ///< Switched back to the primary, the next failure returns to healthy_index_
+  uint32_t broker_attempts_start_{0};  ///< millis() of the first attempt on the current broker
+  enum FailbackState : uint8_t {
+    FAILBACK_IDLE,
+    FAILBACK_RESOLVING,
+    FAILBACK_RESOLVED,
+    FAILBACK_PROBING,
+  };
+  FailbackState failback_state_{FAILBACK_IDLE};
+  uint32_t failback_started_at_{0};
+  network::IPAddress failback_ip_;
+  MQTTTcpProbe failback_probe_;
+  ESPPreferenceObject broker_index_pref_;
+#endif
+  uint32_t connected_at_{0};  ///< millis() of the last CONNACK
+  bool settled_{false};       ///< MQTT_CONNECT_SETTLE_TIME has passed since connected_at_
   uint32_t last_connected_{0};
   optional<MQTTClientDisconnectReason> disconnect_reason_{};
   CallbackManager<MQTTBackend::on_disconnect_callback_t> on_disconnect_;
+#ifdef USE_MQTT_TELEMETRY
+  MQTTHistogram dns_time_histogram_;
+  MQTTHistogram connect_time_histogram_;
+  MQTTHistogram loop_time_histogram_;  ///< Microseconds per loop() call
+  uint32_t connected_s_{0};             ///< Seconds connected, up to telemetry_connected_at_
+  uint32_t telemetry_connected_at_{0};  ///< millis() the current connection was last folded into connected_s_
+  bool telemetry_connected_{false};
+  uint16_t connects_{0};
+  uint16_t disconnect_counts_[MQTT_DISCONNECT_REASON_COUNT]{};
+#ifdef USE_SENSOR
+  sensor::Sensor *dns_time_sensor_{nullptr};
+  sensor::Sensor *reconnects_sensor_{nullptr};
+  sensor::Sensor *disconnects_sensor_{nullptr};
+  sensor::Sensor *connected_time_sensor_{nullptr};
+#endif
+#endif
+#ifdef USE_MQTT_LATENCY_PROBE
+  std::string latency_probe_topic_;
+  MQTTHistogram latency_histogram_;
+  uint32_t latency_probe_interval_{60000};
+  uint32_t latency_probe_sent_at_{0};  ///< millis() of the probe waiting for its echo, 0 if none
+  uint32_t latency_probes_lost_{0};
+  uint8_t latency_probe_qos_{0};
+#ifdef USE_SENSOR
+  sensor::Sensor *latency_p50_sensor_{nullptr};
+  sensor::Sensor *latency_p95_sensor_{nullptr};
+  sensor::Sensor *latency_max_sensor_{nullptr};
+#endif
+#endif
+#ifdef USE_MQTT_BURST
+  uint16_t inflight_{0};  ///< QoS>0 publishes not acknowledged yet
+  bool burst_complete_{false};
+  uint32_t subscriptions_hash_{0};
+  ESPPreferenceObject subscriptions_pref_;
+  CallbackManager<void(uint32_t)> on_burst_complete_;
+#endif
 
   bool publish_nan_as_none_{false};
   bool wait_for_connection_{false};
+
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  bool skip_unchanged_persist_{false};
+  bool session_present_{false};
+#endif
+
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  bool device_discovery_pending_{false};
+  /// Moving the retained per-entity configs of the single-component mode over to the device payload.
+  enum EntityDiscoveryStep : uint8_t {
+    ENTITY_DISCOVERY_DONE,
+    ENTITY_DISCOVERY_MIGRATE,   ///< Announce the move on every per-entity topic
+    ENTITY_DISCOVERY_ANNOUNCE,  ///< Publish the device payload
+    ENTITY_DISCOVERY_CLEAN,     ///< Clear the per-entity topics
+  } entity_discovery_step_{ENTITY_DISCOVERY_MIGRATE};
+  size_t entity_discovery_index_{0};  ///< Next child in publish_entity_discoveries_()
+  ESPPreferenceObject entity_discovery_pref_;
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  uint32_t device_discovery_hash_{0};
+  ESPPreferenceObject device_discovery_pref_;
+#endif
+#endif
+
+  uint32_t resend_budget_us_{5000};
+  uint32_t resend_failed_at_{0};  ///< millis() of the last failed resend
+  uint32_t resend_backoff_{0};    ///< Wait after resend_failed_at_ before the next resend pass, 0 after a success
+  uint32_t sync_start_{0};  ///< millis() at CONNACK while resends are outstanding, 0 once synced
+  uint32_t first_state_at_{0};  ///< millis() of the first state handed to the broker since boot, 0 until then
+#ifdef USE_SENSOR
+  sensor::Sensor *sync_duration_sensor_{nullptr};
+  sensor::Sensor *connect_duration_sensor_{nullptr};
+#endif
+
+#ifdef USE_MQTT_COMPRESSION
+  std::vector<const char *> compressed_topics_;
+  const char *compression_topic_suffix_{""};
+  std::unique_ptr<uint8_t[]> compression_buffer_;  ///< Reused output buffer, grown to the largest payload seen
+  size_t compression_buffer_size_{0};
+  /// Separate buffer for publish_log_(): a log line emitted while publish() still uses compression_buffer_ must
+  /// not overwrite it
+  std::unique_ptr<uint8_t[]> log_compression_buffer_;
+  size_t log_compression_buffer_size_{0};
+  size_t compression_min_size_{0};
+  size_t compression_max_size_{0};
+  uint8_t compression_window_bits_{8};
+  uint8_t compression_lookahead_bits_{4};
+#endif
 };
 
 extern MQTTClientComponent *global_mqtt_client;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
@@ -382,6 +903,15 @@ class MQTTDisconnectTrigger final : public Trigger<MQTTClientDisconnectReason> {
   }
 };
 
+#ifdef USE_MQTT_BURST
+class MQTTBurstCompleteTrigger final : public Trigger<uint32_t> {
+ public:
+  explicit MQTTBurstCompleteTrigger(MQTTClientComponent *client) {
+    client->add_on_burst_complete_callback([this](uint32_t elapsed) { this->trigger(elapsed); });
+  }
+};
+#endif
+
 template<typename... Ts> class MQTTPublishAction final : public Action<Ts...> {
  public:
   MQTTPublishAction(MQTTClientComponent *parent) : parent_(parent) {}
@@ -390,13 +920,37 @@ template<typename... Ts> class MQTTPublishAction final : public Action<Ts...> {
   TEMPLATABLE_VALUE(uint8_t, qos)
   TEMPLATABLE_VALUE(bool, retain)
 
+  /// Topic known at compile time, published without building a std::string.
+  void set_topic_static(const char *topic) { this->topic_static_ = topic; }
+  /// Payload known at compile time, published without building a std::string.
+  void set_payload_static(const char *payload, size_t payload_length) {
+    this->payload_static_ = payload;
+    this->payload_static_length_ = payload_length;
+  }
+
   void play(const Ts &...x) override {
-    this->parent_->publish(this->topic_.value(x...), this->payload_.value(x...), this->qos_.value(x...),
-                           this->retain_.value(x...));
+    std::string topic;
+    std::string payload;
+    const char *topic_ptr = this->topic_static_;
+    if (topic_ptr == nullptr) {
+      topic = this->topic_.value(x...);
+      topic_ptr = topic.c_str();
+    }
+    const char *payload_ptr = this->payload_static_;
+    size_t payload_length = this->payload_static_length_;
+    if (payload_ptr == nullptr) {
+      payload = this->payload_.value(x...);
+      payload_ptr = payload.data();
+      payload_length = payload.size();
+    }
+    this->parent_->publish(topic_ptr, payload_ptr, payload_length, this->qos_.value(x...), this->retain_.value(x...));
   }
 
  protected:
   MQTTClientComponent *parent_;
+  const char *topic_static_{nullptr};
+  const char *payload_static_{nullptr};
+  size_t payload_static_length_{0};
 };
 
 template<typename... Ts> class MQTTPublishJsonAction final : public Action<Ts...> {
@@ -406,19 +960,28 @@ template<typename... Ts> class MQTTPublishJsonAction final : public Action<Ts...
   TEMPLATABLE_VALUE(uint8_t, qos)
   TEMPLATABLE_VALUE(bool, retain)
 
+  /// Topic known at compile time, published without building a std::string.
+  void set_topic_static(const char *topic) { this->topic_static_ = topic; }
   void set_payload(std::function<void(Ts..., JsonObject)> payload) { this->payload_ = payload; }
 
   void play(const Ts &...x) override {
-    auto topic = this->topic_.value(x...);
+    std::string topic;
+    const char *topic_ptr = this->topic_static_;
+    if (topic_ptr == nullptr) {
+      topic = this->topic_.value(x...);
+      topic_ptr = topic.c_str();
+    }
     auto qos = this->qos_.value(x...);
     auto retain = this->retain_.value(x...);
+    // publish_json() invokes the builder synchronously, so the arguments can be captured by reference
     this->parent_->publish_json(
-        topic, [this, x...](JsonObject root) { this->payload_(x..., root); }, qos, retain);
+        topic_ptr, [this, &x...](JsonObject root) { this->payload_(x..., root); }, qos, retain);
   }
 
  protected:
   std::function<void(Ts..., JsonObject)> payload_;
   MQTTClientComponent *parent_;
+  const char *topic_static_{nullptr};
 };
 
 template<typename... Ts> class MQTTConnectedCondition final : public Condition<Ts...> {
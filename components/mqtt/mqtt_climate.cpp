@@ -57,18 +57,38 @@ static ProgmemStr climate_preset_to_mqtt_str(ClimatePreset preset) {
 void MQTTClimateComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) {
   // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
   auto traits = this->device_->get_traits();
+  char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+#ifdef USE_MQTT_CLIMATE_JSON
+  const bool json_state = this->use_json_format_;
+  char state_topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+  StringRef json_state_topic = this->get_state_topic_to_(state_topic_buf);
+#endif
+  // In JSON mode every *_state_topic points at the single state topic and a template extracts the field
+  auto add_state_topic = [&](auto topic_key, StringRef sub_topic, auto template_key, auto value_template) {
+#ifdef USE_MQTT_CLIMATE_JSON
+    if (json_state) {
+      root[topic_key] = json_state_topic;
+      root[template_key] = value_template;
+      return;
+    }
+#endif
+    root[topic_key] = sub_topic;
+  };
   // current_temperature_topic
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_TEMPERATURE)) {
-    root[MQTT_CURRENT_TEMPERATURE_TOPIC] = this->get_current_temperature_state_topic();
+    add_state_topic(MQTT_CURRENT_TEMPERATURE_TOPIC, this->get_current_temperature_state_topic_to(topic_buf),
+                    MQTT_CURRENT_TEMPERATURE_TEMPLATE, ESPHOME_F("{{ value_json.current_temperature }}"));
   }
   // current_humidity_topic
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_HUMIDITY)) {
-    root[MQTT_CURRENT_HUMIDITY_TOPIC] = this->get_current_humidity_state_topic();
+    add_state_topic(MQTT_CURRENT_HUMIDITY_TOPIC, this->get_current_humidity_state_topic_to(topic_buf),
+                    MQTT_CURRENT_HUMIDITY_TEMPLATE, ESPHOME_F("{{ value_json.current_humidity }}"));
   }
   // mode_command_topic
   root[MQTT_MODE_COMMAND_TOPIC] = this->get_mode_command_topic();
   // mode_state_topic
-  root[MQTT_MODE_STATE_TOPIC] = this->get_mode_state_topic();
+  add_state_topic(MQTT_MODE_STATE_TOPIC, this->get_mode_state_topic_to(topic_buf), MQTT_MODE_STATE_TEMPLATE,
+                  ESPHOME_F("{{ value_json.mode }}"));
   // modes
   JsonArray modes = root[MQTT_MODES].to<JsonArray>();
   // sort array for nice UI in HA
@@ -91,23 +111,27 @@ void MQTTClimateComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryCo
     // temperature_low_command_topic
     root[MQTT_TEMPERATURE_LOW_COMMAND_TOPIC] = this->get_target_temperature_low_command_topic();
     // temperature_low_state_topic
-    root[MQTT_TEMPERATURE_LOW_STATE_TOPIC] = this->get_target_temperature_low_state_topic();
+    add_state_topic(MQTT_TEMPERATURE_LOW_STATE_TOPIC, this->get_target_temperature_low_state_topic_to(topic_buf),
+                    MQTT_TEMPERATURE_LOW_STATE_TEMPLATE, ESPHOME_F("{{ value_json.target_temperature_low }}"));
     // temperature_high_command_topic
     root[MQTT_TEMPERATURE_HIGH_COMMAND_TOPIC] = this->get_target_temperature_high_command_topic();
     // temperature_high_state_topic
-    root[MQTT_TEMPERATURE_HIGH_STATE_TOPIC] = this->get_target_temperature_high_state_topic();
+    add_state_topic(MQTT_TEMPERATURE_HIGH_STATE_TOPIC, this->get_target_temperature_high_state_topic_to(topic_buf),
+                    MQTT_TEMPERATURE_HIGH_STATE_TEMPLATE, ESPHOME_F("{{ value_json.target_temperature_high }}"));
   } else {
     // temperature_command_topic
     root[MQTT_TEMPERATURE_COMMAND_TOPIC] = this->get_target_temperature_command_topic();
     // temperature_state_topic
-    root[MQTT_TEMPERATURE_STATE_TOPIC] = this->get_target_temperature_state_topic();
+    add_state_topic(MQTT_TEMPERATURE_STATE_TOPIC, this->get_target_temperature_state_topic_to(topic_buf),
+                    MQTT_TEMPERATURE_STATE_TEMPLATE, ESPHOME_F("{{ value_json.target_temperature }}"));
   }
 
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_TARGET_HUMIDITY)) {
     // target_humidity_command_topic
     root[MQTT_TARGET_HUMIDITY_COMMAND_TOPIC] = this->get_target_humidity_command_topic();
     // target_humidity_state_topic
-    root[MQTT_TARGET_HUMIDITY_STATE_TOPIC] = this->get_target_humidity_state_topic();
+    add_state_topic(MQTT_TARGET_HUMIDITY_STATE_TOPIC, this->get_target_humidity_state_topic_to(topic_buf),
+                    MQTT_TARGET_HUMIDITY_STATE_TEMPLATE, ESPHOME_F("{{ value_json.target_humidity }}"));
   }
 
   // min_temp
@@ -130,7 +154,8 @@ void MQTTClimateComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryCo
     // preset_mode_command_topic
     root[MQTT_PRESET_MODE_COMMAND_TOPIC] = this->get_preset_command_topic();
     // preset_mode_state_topic
-    root[MQTT_PRESET_MODE_STATE_TOPIC] = this->get_preset_state_topic();
+    add_state_topic(MQTT_PRESET_MODE_STATE_TOPIC, this->get_preset_state_topic_to(topic_buf),
+                    MQTT_PRESET_MODE_VALUE_TEMPLATE, ESPHOME_F("{{ value_json.preset }}"));
     // presets
     JsonArray presets = root[ESPHOME_F("preset_modes")].to<JsonArray>();
     if (traits.supports_preset(CLIMATE_PRESET_HOME))
@@ -153,14 +178,16 @@ void MQTTClimateComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryCo
 
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_ACTION)) {
     // action_topic
-    root[MQTT_ACTION_TOPIC] = this->get_action_state_topic();
+    add_state_topic(MQTT_ACTION_TOPIC, this->get_action_state_topic_to(topic_buf), MQTT_ACTION_TEMPLATE,
+                    ESPHOME_F("{{ value_json.action }}"));
   }
 
   if (traits.get_supports_fan_modes()) {
     // fan_mode_command_topic
     root[MQTT_FAN_MODE_COMMAND_TOPIC] = this->get_fan_mode_command_topic();
     // fan_mode_state_topic
-    root[MQTT_FAN_MODE_STATE_TOPIC] = this->get_fan_mode_state_topic();
+    add_state_topic(MQTT_FAN_MODE_STATE_TOPIC, this->get_fan_mode_state_topic_to(topic_buf),
+                    MQTT_FAN_MODE_STATE_TEMPLATE, ESPHOME_F("{{ value_json.fan_mode }}"));
     // fan_modes
     JsonArray fan_modes = root[ESPHOME_F("fan_modes")].to<JsonArray>();
     if (traits.supports_fan_mode(CLIMATE_FAN_ON))
@@ -191,7 +218,8 @@ void MQTTClimateComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryCo
     // swing_mode_command_topic
     root[MQTT_SWING_MODE_COMMAND_TOPIC] = this->get_swing_mode_command_topic();
     // swing_mode_state_topic
-    root[MQTT_SWING_MODE_STATE_TOPIC] = this->get_swing_mode_state_topic();
+    add_state_topic(MQTT_SWING_MODE_STATE_TOPIC, this->get_swing_mode_state_topic_to(topic_buf),
+                    MQTT_SWING_MODE_STATE_TEMPLATE, ESPHOME_F("{{ value_json.swing_mode }}"));
     // swing_modes
     JsonArray swing_modes = root[ESPHOME_F("swing_modes")].to<JsonArray>();
     if (traits.supports_swing_mode(CLIMATE_SWING_OFF))
@@ -295,17 +323,44 @@ void MQTTClimateComponent::setup() {
   this->device_->add_on_state_callback([this](Climate & /*unused*/) { this->publish_state_(); });
 }
 MQTTClimateComponent::MQTTClimateComponent(Climate *device) : device_(device) {}
-bool MQTTClimateComponent::send_initial_state() { return this->publish_state_(); }
+void MQTTClimateComponent::dump_config() {
+  ESP_LOGCONFIG(TAG, "MQTT Climate '%s':", this->device_->get_name().c_str());
+  bool json_state = false;
+#ifdef USE_MQTT_CLIMATE_JSON
+  json_state = this->use_json_format_;
+#endif
+  // The component's own state topic only carries the JSON document, sub-topics are used otherwise
+  LOG_MQTT_COMPONENT(json_state, false);
+  char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+  if (json_state) {
+    ESP_LOGCONFIG(TAG, "  JSON State Payload: YES");
+  } else {
+    ESP_LOGCONFIG(TAG, "  Mode State Topic: '%s'", this->get_mode_state_topic_to(topic_buf).c_str());
+  }
+  ESP_LOGCONFIG(TAG, "  Mode Command Topic: '%s'", this->get_mode_command_topic_to(topic_buf).c_str());
+}
+bool MQTTClimateComponent::send_initial_state() {
+  // Initial state (also sent on reconnect) always publishes every sub-topic
+  this->state_snapshot_.invalidate();
+  return this->publish_state_();
+}
 MQTT_COMPONENT_TYPE(MQTTClimateComponent, "climate")
 const EntityBase *MQTTClimateComponent::get_entity() const { return this->device_; }
 
 bool MQTTClimateComponent::publish_state_() {
+#ifdef USE_MQTT_CLIMATE_JSON
+  if (this->use_json_format_)
+    return this->publish_state_json_();
+#endif
   auto traits = this->device_->get_traits();
   // Reusable stack buffer for topic construction (avoids heap allocation per publish)
   char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+  // Only sub-topics whose payload changed since the last publish are sent, see send_initial_state()
+  auto &snapshot = this->state_snapshot_;
   // mode
   bool success = true;
-  if (!this->publish(this->get_mode_state_topic_to(topic_buf), climate_mode_to_mqtt_str(this->device_->mode)))
+  if (!this->publish_if_changed_(snapshot, SLOT_MODE, this->get_mode_state_topic_to(topic_buf),
+                                 climate_mode_to_mqtt_str(this->device_->mode)))
     success = false;
   int8_t target_accuracy = traits.get_target_temperature_accuracy_decimals();
   int8_t current_accuracy = traits.get_current_temperature_accuracy_decimals();
@@ -314,76 +369,154 @@ bool MQTTClimateComponent::publish_state_() {
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_TEMPERATURE) &&
       !std::isnan(this->device_->current_temperature)) {
     len = value_accuracy_to_buf(payload, this->device_->current_temperature, current_accuracy);
-    if (!this->publish(this->get_current_temperature_state_topic_to(topic_buf), payload, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_CURRENT_TEMPERATURE,
+                                   this->get_current_temperature_state_topic_to(topic_buf), payload, len))
       success = false;
   }
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE |
                                climate::CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE)) {
     len = value_accuracy_to_buf(payload, this->device_->target_temperature_low, target_accuracy);
-    if (!this->publish(this->get_target_temperature_low_state_topic_to(topic_buf), payload, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_TARGET_TEMPERATURE_LOW,
+                                   this->get_target_temperature_low_state_topic_to(topic_buf), payload, len))
       success = false;
     len = value_accuracy_to_buf(payload, this->device_->target_temperature_high, target_accuracy);
-    if (!this->publish(this->get_target_temperature_high_state_topic_to(topic_buf), payload, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_TARGET_TEMPERATURE_HIGH,
+                                   this->get_target_temperature_high_state_topic_to(topic_buf), payload, len))
       success = false;
   } else {
     len = value_accuracy_to_buf(payload, this->device_->target_temperature, target_accuracy);
-    if (!this->publish(this->get_target_temperature_state_topic_to(topic_buf), payload, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_TARGET_TEMPERATURE,
+                                   this->get_target_temperature_state_topic_to(topic_buf), payload, len))
       success = false;
   }
 
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_HUMIDITY) &&
       !std::isnan(this->device_->current_humidity)) {
     len = value_accuracy_to_buf(payload, this->device_->current_humidity, 0);
-    if (!this->publish(this->get_current_humidity_state_topic_to(topic_buf), payload, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_CURRENT_HUMIDITY,
+                                   this->get_current_humidity_state_topic_to(topic_buf), payload, len))
       success = false;
   }
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_TARGET_HUMIDITY) &&
       !std::isnan(this->device_->target_humidity)) {
     len = value_accuracy_to_buf(payload, this->device_->target_humidity, 0);
-    if (!this->publish(this->get_target_humidity_state_topic_to(topic_buf), payload, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_TARGET_HUMIDITY, this->get_target_humidity_state_topic_to(topic_buf),
+                                   payload, len))
       success = false;
   }
 
   if (traits.get_supports_presets() || !traits.get_supported_custom_presets().empty()) {
     if (this->device_->has_custom_preset()) {
-      if (!this->publish(this->get_preset_state_topic_to(topic_buf), this->device_->get_custom_preset().c_str()))
+      if (!this->publish_if_changed_(snapshot, SLOT_PRESET, this->get_preset_state_topic_to(topic_buf),
+                                     this->device_->get_custom_preset().c_str()))
         success = false;
     } else if (this->device_->preset.has_value()) {
-      if (!this->publish(this->get_preset_state_topic_to(topic_buf),
-                         climate_preset_to_mqtt_str(this->device_->preset.value())))
+      if (!this->publish_if_changed_(snapshot, SLOT_PRESET, this->get_preset_state_topic_to(topic_buf),
+                                     climate_preset_to_mqtt_str(this->device_->preset.value())))
         success = false;
-    } else if (!this->publish(this->get_preset_state_topic_to(topic_buf), "")) {
+    } else if (!this->publish_if_changed_(snapshot, SLOT_PRESET, this->get_preset_state_topic_to(topic_buf), "")) {
       success = false;
     }
   }
 
   if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_ACTION)) {
-    if (!this->publish(this->get_action_state_topic_to(topic_buf), climate_action_to_mqtt_str(this->device_->action)))
+    if (!this->publish_if_changed_(snapshot, SLOT_ACTION, this->get_action_state_topic_to(topic_buf),
+                                   climate_action_to_mqtt_str(this->device_->action)))
       success = false;
   }
 
   if (traits.get_supports_fan_modes()) {
     if (this->device_->has_custom_fan_mode()) {
-      if (!this->publish(this->get_fan_mode_state_topic_to(topic_buf), this->device_->get_custom_fan_mode().c_str()))
+      if (!this->publish_if_changed_(snapshot, SLOT_FAN_MODE, this->get_fan_mode_state_topic_to(topic_buf),
+                                     this->device_->get_custom_fan_mode().c_str()))
         success = false;
     } else if (this->device_->fan_mode.has_value()) {
-      if (!this->publish(this->get_fan_mode_state_topic_to(topic_buf),
-                         climate_fan_mode_to_mqtt_str(this->device_->fan_mode.value())))
+      if (!this->publish_if_changed_(snapshot, SLOT_FAN_MODE, this->get_fan_mode_state_topic_to(topic_buf),
+                                     climate_fan_mode_to_mqtt_str(this->device_->fan_mode.value())))
         success = false;
-    } else if (!this->publish(this->get_fan_mode_state_topic_to(topic_buf), "")) {
+    } else if (!this->publish_if_changed_(snapshot, SLOT_FAN_MODE, this->get_fan_mode_state_topic_to(topic_buf), "")) {
       success = false;
     }
   }
 
   if (traits.get_supports_swing_modes()) {
-    if (!this->publish(this->get_swing_mode_state_topic_to(topic_buf),
-                       climate_swing_mode_to_mqtt_str(this->device_->swing_mode)))
+    if (!this->publish_if_changed_(snapshot, SLOT_SWING_MODE, this->get_swing_mode_state_topic_to(topic_buf),
+                                   climate_swing_mode_to_mqtt_str(this->device_->swing_mode)))
       success = false;
   }
 
   return success;
 }
 
+#ifdef USE_MQTT_CLIMATE_JSON
+// Round to the same number of decimals the per-topic payloads use
+static float round_to_accuracy(float value, int8_t accuracy_decimals) {
+  float multiplier = powf(10.0f, accuracy_decimals);
+  return roundf(value * multiplier) / multiplier;
+}
+
+bool MQTTClimateComponent::publish_state_json_() {
+  auto traits = this->device_->get_traits();
+  int8_t target_accuracy = traits.get_target_temperature_accuracy_decimals();
+  int8_t current_accuracy = traits.get_current_temperature_accuracy_decimals();
+  auto message = json::build_json([this, &traits, target_accuracy, current_accuracy](JsonObject root) {
+    // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
+    root[ESPHOME_F("mode")] = climate_mode_to_mqtt_str(this->device_->mode);
+    if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_TEMPERATURE) &&
+        !std::isnan(this->device_->current_temperature)) {
+      root[ESPHOME_F("current_temperature")] =
+          round_to_accuracy(this->device_->current_temperature, current_accuracy);
+    }
+    if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE |
+                                 climate::CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE)) {
+      root[ESPHOME_F("target_temperature_low")] =
+          round_to_accuracy(this->device_->target_temperature_low, target_accuracy);
+      root[ESPHOME_F("target_temperature_high")] =
+          round_to_accuracy(this->device_->target_temperature_high, target_accuracy);
+    } else {
+      root[ESPHOME_F("target_temperature")] = round_to_accuracy(this->device_->target_temperature, target_accuracy);
+    }
+    if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_HUMIDITY) &&
+        !std::isnan(this->device_->current_humidity)) {
+      root[ESPHOME_F("current_humidity")] = roundf(this->device_->current_humidity);
+    }
+    if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_TARGET_HUMIDITY) &&
+        !std::isnan(this->device_->target_humidity)) {
+      root[ESPHOME_F("target_humidity")] = roundf(this->device_->target_humidity);
+    }
+    if (traits.get_supports_presets() || !traits.get_supported_custom_presets().empty()) {
+      if (this->device_->has_custom_preset()) {
+        root[ESPHOME_F("preset")] = this->device_->get_custom_preset();
+      } else if (this->device_->preset.has_value()) {
+        root[ESPHOME_F("preset")] = climate_preset_to_mqtt_str(this->device_->preset.value());
+      } else {
+        root[ESPHOME_F("preset")] = "";
+      }
+    }
+    if (traits.has_feature_flags(climate::CLIMATE_SUPPORTS_ACTION)) {
+      root[ESPHOME_F("action")] = climate_action_to_mqtt_str(this->device_->action);
+    }
+    if (traits.get_supports_fan_modes()) {
+      if (this->device_->has_custom_fan_mode()) {
+        root[ESPHOME_F("fan_mode")] = this->device_->get_custom_fan_mode();
+      } else if (this->device_->fan_mode.has_value()) {
+        root[ESPHOME_F("fan_mode")] = climate_fan_mode_to_mqtt_str(this->device_->fan_mode.value());
+      } else {
+        root[ESPHOME_F("fan_mode")] = "";
+      }
+    }
+    if (traits.get_supports_swing_modes()) {
+      root[ESPHOME_F("swing_mode")] = climate_swing_mode_to_mqtt_str(this->device_->swing_mode);
+    }
+    // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+  });
+  char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+  // The whole document occupies the first snapshot slot, so unchanged state is still not republished
+  return this->publish_if_changed_(this->state_snapshot_, SLOT_STATE, this->get_state_topic_to_(topic_buf),
+                                   message.c_str(), message.size());
+}
+#endif
+
 }  // namespace esphome::mqtt
 
 #endif
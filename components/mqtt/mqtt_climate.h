@@ -17,6 +17,7 @@ class MQTTClimateComponent final : public mqtt::MQTTComponent {
   bool send_initial_state() override;
   const char *component_type() const override;
   void setup() override;
+  void dump_config() override;
 
   MQTT_COMPONENT_CUSTOM_TOPIC(current_temperature, state)
   MQTT_COMPONENT_CUSTOM_TOPIC(current_humidity, state)
@@ -40,12 +41,40 @@ class MQTTClimateComponent final : public mqtt::MQTTComponent {
   MQTT_COMPONENT_CUSTOM_TOPIC(preset, state)
   MQTT_COMPONENT_CUSTOM_TOPIC(preset, command)
 
+#ifdef USE_MQTT_CLIMATE_JSON
+  void set_use_json_format(bool use_json_format) { this->use_json_format_ = use_json_format; }
+#endif
+
  protected:
   const EntityBase *get_entity() const override;
 
   bool publish_state_();
+#ifdef USE_MQTT_CLIMATE_JSON
+  bool publish_state_json_();
+#endif
+
+  /// State sub-topic slots for delta publishing.
+  enum StateSlot : uint8_t {
+    SLOT_MODE = 0,
+    SLOT_CURRENT_TEMPERATURE,
+    SLOT_TARGET_TEMPERATURE,
+    SLOT_TARGET_TEMPERATURE_LOW,
+    SLOT_TARGET_TEMPERATURE_HIGH,
+    SLOT_CURRENT_HUMIDITY,
+    SLOT_TARGET_HUMIDITY,
+    SLOT_PRESET,
+    SLOT_ACTION,
+    SLOT_FAN_MODE,
+    SLOT_SWING_MODE,
+    SLOT_COUNT,
+    SLOT_STATE = SLOT_MODE,  ///< JSON state mode keeps the whole document in the first slot
+  };
 
   climate::Climate *device_;
+  MQTTStateSnapshot<SLOT_COUNT> state_snapshot_;
+#ifdef USE_MQTT_CLIMATE_JSON
+  bool use_json_format_{false};
+#endif
 };
 
 }  // namespace esphome::mqtt
@@ -5,6 +5,7 @@
 #include "esphome/core/application.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
 #include "esphome/core/progmem.h"
 #include "esphome/core/version.h"
 
@@ -45,6 +46,64 @@ void log_mqtt_component(const char *tag, MQTTComponent *obj, bool state_topic, b
     ESP_LOGCONFIG(tag, "  Command Topic: '%s'", obj->get_command_topic_to_(buf).c_str());
 }
 
+void build_mqtt_device_info(JsonObject device_info) {
+  const auto &node_name = App.get_name();
+  const auto &friendly_name_ref = App.get_friendly_name();
+  const auto &node_friendly_name = friendly_name_ref.empty() ? node_name : friendly_name_ref;
+  const char *node_area = App.get_area();
+
+  char mac[MAC_ADDRESS_BUFFER_SIZE];
+  get_mac_address_into_buffer(mac);
+  device_info[MQTT_DEVICE_IDENTIFIERS] = mac;
+  device_info[MQTT_DEVICE_NAME] = node_friendly_name;
+#ifdef ESPHOME_PROJECT_NAME
+  device_info[MQTT_DEVICE_SW_VERSION] = ESPHOME_PROJECT_VERSION " (ESPHome " ESPHOME_VERSION ")";
+  const char *model = std::strchr(ESPHOME_PROJECT_NAME, '.');
+  device_info[MQTT_DEVICE_MODEL] = model == nullptr ? ESPHOME_BOARD : model + 1;
+  if (model == nullptr) {
+    device_info[MQTT_DEVICE_MANUFACTURER] = ESPHOME_PROJECT_NAME;
+  } else {
+    // Extract manufacturer (part before '.') using stack buffer to avoid heap allocation
+    // memcpy is used instead of strncpy since we know the exact length and strncpy
+    // would still require manual null-termination
+    char manufacturer[sizeof(ESPHOME_PROJECT_NAME)];
+    size_t len = model - ESPHOME_PROJECT_NAME;
+    memcpy(manufacturer, ESPHOME_PROJECT_NAME, len);
+    manufacturer[len] = '\0';
+    device_info[MQTT_DEVICE_MANUFACTURER] = manufacturer;
+  }
+#else
+  static const char ver_fmt[] PROGMEM = ESPHOME_VERSION " (config hash 0x%08" PRIx32 ")";
+  // Buffer sized for format string expansion: ~4 bytes net growth from format specifier to 8 hex digits, plus
+  // safety margin
+  char version_buf[sizeof(ver_fmt) + 8];
+#ifdef USE_ESP8266
+  snprintf_P(version_buf, sizeof(version_buf), ver_fmt, App.get_config_hash());
+#else
+  snprintf(version_buf, sizeof(version_buf), ver_fmt, App.get_config_hash());
+#endif
+  device_info[MQTT_DEVICE_SW_VERSION] = version_buf;
+  device_info[MQTT_DEVICE_MODEL] = ESPHOME_BOARD;
+#if defined(USE_ESP8266) || defined(USE_ESP32)
+  device_info[MQTT_DEVICE_MANUFACTURER] = "Espressif";
+#elif defined(USE_RP2)
+  device_info[MQTT_DEVICE_MANUFACTURER] = "Raspberry Pi";
+#elif defined(USE_BK72XX)
+  device_info[MQTT_DEVICE_MANUFACTURER] = "Beken";
+#elif defined(USE_RTL87XX)
+  device_info[MQTT_DEVICE_MANUFACTURER] = "Realtek";
+#elif defined(USE_HOST)
+  device_info[MQTT_DEVICE_MANUFACTURER] = "Host";
+#endif
+#endif
+  if (node_area[0] != '\0') {
+    device_info[MQTT_DEVICE_SUGGESTED_AREA] = node_area;
+  }
+
+  device_info[MQTT_DEVICE_CONNECTIONS][0][0] = "mac";
+  device_info[MQTT_DEVICE_CONNECTIONS][0][1] = mac;
+}
+
 void MQTTComponent::set_qos(uint8_t qos) { this->qos_ = qos; }
 
 void MQTTComponent::set_subscribe_qos(uint8_t qos) { this->subscribe_qos_ = qos; }
@@ -144,7 +203,7 @@ bool MQTTComponent::publish(const std::string &topic, const char *payload, size_
 bool MQTTComponent::publish(const char *topic, const char *payload, size_t payload_length) {
   if (topic[0] == '\0')
     return false;
-  return global_mqtt_client->publish(topic, payload, payload_length, this->qos_, this->retain_);
+  return this->track_publish_(global_mqtt_client->publish(topic, payload, payload_length, this->qos_, this->retain_));
 }
 
 bool MQTTComponent::publish(const char *topic, const char *payload) {
@@ -163,7 +222,7 @@ bool MQTTComponent::publish(const char *topic, ProgmemStr payload) {
   char buf[64];
   strncpy_P(buf, reinterpret_cast<const char *>(payload), sizeof(buf) - 1);
   buf[sizeof(buf) - 1] = '\0';
-  return global_mqtt_client->publish(topic, buf, strlen(buf), this->qos_, this->retain_);
+  return this->track_publish_(global_mqtt_client->publish(topic, buf, strlen(buf), this->qos_, this->retain_));
 }
 #endif
 
@@ -174,10 +233,20 @@ bool MQTTComponent::publish_json(const std::string &topic, const json::json_buil
 bool MQTTComponent::publish_json(const char *topic, const json::json_build_t &f) {
   if (topic[0] == '\0')
     return false;
-  return global_mqtt_client->publish_json(topic, f, this->qos_, this->retain_);
+#ifdef USE_MQTT_MSGPACK
+  // Home Assistant reads discovered entities through value_json and its JSON schemas, so they stay JSON text
+  if (this->is_discovery_enabled())
+    return this->track_publish_(global_mqtt_client->publish_json_text(topic, f, this->qos_, this->retain_));
+#endif
+  return this->track_publish_(global_mqtt_client->publish_json(topic, f, this->qos_, this->retain_));
 }
 
 bool MQTTComponent::send_discovery_() {
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  // All entities are announced together, see MQTTClientComponent::send_device_discovery_()
+  global_mqtt_client->schedule_device_discovery();
+  return true;
+#else
   const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
 
   char discovery_topic_buf[MQTT_DISCOVERY_TOPIC_MAX_LEN];
@@ -191,155 +260,192 @@ bool MQTTComponent::send_discovery_() {
   ESP_LOGV(TAG, "'%s': Sending discovery", this->friendly_name_().c_str());
 
   // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
-  return global_mqtt_client->publish_json(
-      discovery_topic.c_str(),
-      [this](JsonObject root) {
-        SendDiscoveryConfig config;
-        config.state_topic = true;
-        config.command_topic = true;
-
-        this->send_discovery(root, config);
-        // Set subscription QoS (default is 0)
-        if (this->subscribe_qos_ != 0) {
-          root[MQTT_QOS] = this->subscribe_qos_;
-        }
-
-        // Fields from EntityBase
-        root[MQTT_NAME] = this->get_entity()->has_own_name() ? this->friendly_name_() : StringRef();
-
-        if (this->is_disabled_by_default_())
-          root[MQTT_ENABLED_BY_DEFAULT] = false;
-        char icon_buf[MAX_ICON_LENGTH];
-        const char *icon = this->get_icon_to_(icon_buf);
-        if (icon[0] != '\0') {
-          root[MQTT_ICON] = icon;
-        }
-        char dc_buf[MAX_DEVICE_CLASS_LENGTH];
-        const char *dc = this->get_entity()->get_device_class_to(dc_buf);
-        if (dc[0] != '\0') {
-          root[MQTT_DEVICE_CLASS] = dc;
-        }
-
-        const auto entity_category = this->get_entity()->get_entity_category();
-        if (entity_category != ENTITY_CATEGORY_NONE) {
-          root[MQTT_ENTITY_CATEGORY] = EntityCategoryMqttStrings::get_progmem_str(
-              static_cast<uint8_t>(entity_category), static_cast<uint8_t>(ENTITY_CATEGORY_CONFIG));
-        }
-
-        if (config.state_topic) {
-          char state_topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
-          root[MQTT_STATE_TOPIC] = this->get_state_topic_to_(state_topic_buf);
-        }
-        if (config.command_topic) {
-          char command_topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
-          root[MQTT_COMMAND_TOPIC] = this->get_command_topic_to_(command_topic_buf);
-        }
-        if (this->command_retain_)
-          root[MQTT_COMMAND_RETAIN] = true;
-
-        const Availability &avail =
-            this->availability_ == nullptr ? global_mqtt_client->get_availability() : *this->availability_;
-        if (!avail.topic.empty()) {
-          root[MQTT_AVAILABILITY_TOPIC] = avail.topic;
-          if (avail.payload_available != "online")
-            root[MQTT_PAYLOAD_AVAILABLE] = avail.payload_available;
-          if (avail.payload_not_available != "offline")
-            root[MQTT_PAYLOAD_NOT_AVAILABLE] = avail.payload_not_available;
-        }
-
-        const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
-        char object_id_buf[OBJECT_ID_MAX_LEN];
-        StringRef object_id = this->get_default_object_id_to_(object_id_buf);
-        if (discovery_info.unique_id_generator == MQTT_MAC_ADDRESS_UNIQUE_ID_GENERATOR) {
-          char friendly_name_hash[9];
-          buf_append_printf(friendly_name_hash, sizeof(friendly_name_hash), 0, "%08" PRIx32,
-                            fnv1_hash(this->friendly_name_().c_str()));
-          // Format: mac-component_type-hash (e.g. "aabbccddeeff-sensor-12345678")
-          // MAC (12) + "-" (1) + domain (max 20) + "-" (1) + hash (8) + null (1) = 43
-          char unique_id[MAC_ADDRESS_BUFFER_SIZE + ESPHOME_DOMAIN_MAX_LEN + 11];
-          char mac_buf[MAC_ADDRESS_BUFFER_SIZE];
-          get_mac_address_into_buffer(mac_buf);
-          buf_append_printf(unique_id, sizeof(unique_id), 0, "%s-%s-%s", mac_buf, this->component_type(),
-                            friendly_name_hash);
-          root[MQTT_UNIQUE_ID] = unique_id;
-        } else {
-          // default to almost-unique ID. It's a hack but the only way to get that
-          // gorgeous device registry view.
-          // "ESP" (3) + component_type (max 20) + object_id (max 128) + null
-          char unique_id_buf[3 + MQTT_COMPONENT_TYPE_MAX_LEN + OBJECT_ID_MAX_LEN + 1];
-          buf_append_printf(unique_id_buf, sizeof(unique_id_buf), 0, "ESP%s%s", this->component_type(),
-                            object_id.c_str());
-          root[MQTT_UNIQUE_ID] = unique_id_buf;
-        }
-
-        const auto &node_name = App.get_name();
-        if (discovery_info.object_id_generator == MQTT_DEVICE_NAME_OBJECT_ID_GENERATOR) {
-          // node_name (max 31) + "_" (1) + object_id (max 128) + null
-          char object_id_full[ESPHOME_DEVICE_NAME_MAX_LEN + 1 + OBJECT_ID_MAX_LEN + 1];
-          buf_append_printf(object_id_full, sizeof(object_id_full), 0, "%s_%s", node_name.c_str(), object_id.c_str());
-          root[MQTT_OBJECT_ID] = object_id_full;
-        }
-
-        const auto &friendly_name_ref = App.get_friendly_name();
-        const auto &node_friendly_name = friendly_name_ref.empty() ? node_name : friendly_name_ref;
-        const char *node_area = App.get_area();
-
-        JsonObject device_info = root[MQTT_DEVICE].to<JsonObject>();
-        char mac[MAC_ADDRESS_BUFFER_SIZE];
-        get_mac_address_into_buffer(mac);
-        device_info[MQTT_DEVICE_IDENTIFIERS] = mac;
-        device_info[MQTT_DEVICE_NAME] = node_friendly_name;
-#ifdef ESPHOME_PROJECT_NAME
-        device_info[MQTT_DEVICE_SW_VERSION] = ESPHOME_PROJECT_VERSION " (ESPHome " ESPHOME_VERSION ")";
-        const char *model = std::strchr(ESPHOME_PROJECT_NAME, '.');
-        device_info[MQTT_DEVICE_MODEL] = model == nullptr ? ESPHOME_BOARD : model + 1;
-        if (model == nullptr) {
-          device_info[MQTT_DEVICE_MANUFACTURER] = ESPHOME_PROJECT_NAME;
-        } else {
-          // Extract manufacturer (part before '.') using stack buffer to avoid heap allocation
-          // memcpy is used instead of strncpy since we know the exact length and strncpy
-          // would still require manual null-termination
-          char manufacturer[sizeof(ESPHOME_PROJECT_NAME)];
-          size_t len = model - ESPHOME_PROJECT_NAME;
-          memcpy(manufacturer, ESPHOME_PROJECT_NAME, len);
-          manufacturer[len] = '\0';
-          device_info[MQTT_DEVICE_MANUFACTURER] = manufacturer;
-        }
-#else
-        static const char ver_fmt[] PROGMEM = ESPHOME_VERSION " (config hash 0x%08" PRIx32 ")";
-        // Buffer sized for format string expansion: ~4 bytes net growth from format specifier to 8 hex digits, plus
-        // safety margin
-        char version_buf[sizeof(ver_fmt) + 8];
-#ifdef USE_ESP8266
-        snprintf_P(version_buf, sizeof(version_buf), ver_fmt, App.get_config_hash());
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  auto message = json::build_json([this](JsonObject root) { this->build_discovery_(root); });
+  const uint32_t hash = mqtt_payload_hash(message.c_str(), message.size());
+  if (hash == this->discovery_hash_ && discovery_info.retain && global_mqtt_client->is_session_present()) {
+    ESP_LOGV(TAG, "'%s': Discovery unchanged", this->friendly_name_().c_str());
+    return true;
+  }
+  if (!global_mqtt_client->publish(discovery_topic.c_str(), message.c_str(), message.size(), this->qos_,
+                                   discovery_info.retain))
+    return false;
+  if (hash != this->discovery_hash_) {
+    this->discovery_hash_ = hash;
+    if (global_mqtt_client->is_skip_unchanged_persisted())
+      this->discovery_pref_.save(&this->discovery_hash_);
+  }
+  return true;
 #else
-        snprintf(version_buf, sizeof(version_buf), ver_fmt, App.get_config_hash());
+  return global_mqtt_client->publish_json_text(
+      discovery_topic.c_str(), [this](JsonObject root) { this->build_discovery_(root); }, this->qos_,
+      discovery_info.retain);
 #endif
-        device_info[MQTT_DEVICE_SW_VERSION] = version_buf;
-        device_info[MQTT_DEVICE_MODEL] = ESPHOME_BOARD;
-#if defined(USE_ESP8266) || defined(USE_ESP32)
-        device_info[MQTT_DEVICE_MANUFACTURER] = "Espressif";
-#elif defined(USE_RP2)
-        device_info[MQTT_DEVICE_MANUFACTURER] = "Raspberry Pi";
-#elif defined(USE_BK72XX)
-        device_info[MQTT_DEVICE_MANUFACTURER] = "Beken";
-#elif defined(USE_RTL87XX)
-        device_info[MQTT_DEVICE_MANUFACTURER] = "Realtek";
-#elif defined(USE_HOST)
-        device_info[MQTT_DEVICE_MANUFACTURER] = "Host";
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+#endif  // USE_MQTT_DEVICE_DISCOVERY
+}
+
+void MQTTComponent::build_discovery_(JsonObject root) {
+  this->build_entity_discovery_(root);
+  root[MQTT_DEVICE] = serialized(global_mqtt_client->get_device_info_json());
+}
+
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+void MQTTComponent::add_to_device_discovery(JsonObject components) {
+  char unique_id_buf[MQTT_UNIQUE_ID_MAX_LEN];
+  JsonObject component = components[this->get_unique_id_to_(unique_id_buf)].to<JsonObject>();
+  component[MQTT_PLATFORM] = this->component_type();
+  this->build_entity_discovery_(component);
+}
+
+bool MQTTComponent::publish_entity_discovery(const char *payload) {
+  const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
+  char discovery_topic_buf[MQTT_DISCOVERY_TOPIC_MAX_LEN];
+  StringRef discovery_topic = this->get_discovery_topic_to_(discovery_topic_buf, discovery_info);
+  return global_mqtt_client->publish(discovery_topic.c_str(), payload, strlen(payload), this->qos_, true);
+}
 #endif
+
+StringRef MQTTComponent::get_unique_id_to_(std::span<char, MQTT_UNIQUE_ID_MAX_LEN> buf) const {
+  const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
+  size_t len;
+  if (discovery_info.unique_id_generator == MQTT_MAC_ADDRESS_UNIQUE_ID_GENERATOR) {
+    char friendly_name_hash[9];
+    buf_append_printf(friendly_name_hash, sizeof(friendly_name_hash), 0, "%08" PRIx32,
+                      fnv1_hash(this->friendly_name_().c_str()));
+    // Format: mac-component_type-hash (e.g. "aabbccddeeff-sensor-12345678")
+    char mac_buf[MAC_ADDRESS_BUFFER_SIZE];
+    get_mac_address_into_buffer(mac_buf);
+    len = buf_append_printf(buf.data(), buf.size(), 0, "%s-%s-%s", mac_buf, this->component_type(),
+                            friendly_name_hash);
+  } else {
+    // default to almost-unique ID. It's a hack but the only way to get that
+    // gorgeous device registry view.
+    char object_id_buf[OBJECT_ID_MAX_LEN];
+    StringRef object_id = this->get_default_object_id_to_(object_id_buf);
+    len = buf_append_printf(buf.data(), buf.size(), 0, "ESP%s%s", this->component_type(), object_id.c_str());
+  }
+  return StringRef(buf.data(), len);
+}
+
+void MQTTComponent::build_entity_discovery_(JsonObject root) {
+  SendDiscoveryConfig config;
+  config.state_topic = true;
+  config.command_topic = true;
+
+  this->send_discovery(root, config);
+  // Set subscription QoS (default is 0)
+  if (this->subscribe_qos_ != 0) {
+    root[MQTT_QOS] = this->subscribe_qos_;
+  }
+
+  // Fields from EntityBase
+  root[MQTT_NAME] = this->get_entity()->has_own_name() ? this->friendly_name_() : StringRef();
+
+  if (this->is_disabled_by_default_())
+    root[MQTT_ENABLED_BY_DEFAULT] = false;
+  char icon_buf[MAX_ICON_LENGTH];
+  const char *icon = this->get_icon_to_(icon_buf);
+  if (icon[0] != '\0') {
+    root[MQTT_ICON] = icon;
+  }
+  char dc_buf[MAX_DEVICE_CLASS_LENGTH];
+  const char *dc = this->get_entity()->get_device_class_to(dc_buf);
+  if (dc[0] != '\0') {
+    root[MQTT_DEVICE_CLASS] = dc;
+  }
+
+  const auto entity_category = this->get_entity()->get_entity_category();
+  if (entity_category != ENTITY_CATEGORY_NONE) {
+    root[MQTT_ENTITY_CATEGORY] = EntityCategoryMqttStrings::get_progmem_str(
+        static_cast<uint8_t>(entity_category), static_cast<uint8_t>(ENTITY_CATEGORY_CONFIG));
+  }
+
+  if (config.state_topic) {
+    char state_topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+    root[MQTT_STATE_TOPIC] = this->get_state_topic_to_(state_topic_buf);
+  }
+  if (config.command_topic) {
+    char command_topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+    root[MQTT_COMMAND_TOPIC] = this->get_command_topic_to_(command_topic_buf);
+  }
+  if (this->command_retain_)
+    root[MQTT_COMMAND_RETAIN] = true;
+
+  const Availability &avail =
+      this->availability_ == nullptr ? global_mqtt_client->get_availability() : *this->availability_;
+  if (!avail.topic.empty()) {
+    root[MQTT_AVAILABILITY_TOPIC] = avail.topic;
+    if (avail.payload_available != "online")
+      root[MQTT_PAYLOAD_AVAILABLE] = avail.payload_available;
+    if (avail.payload_not_available != "offline")
+      root[MQTT_PAYLOAD_NOT_AVAILABLE] = avail.payload_not_available;
+  }
+
+  char unique_id_buf[MQTT_UNIQUE_ID_MAX_LEN];
+  root[MQTT_UNIQUE_ID] = this->get_unique_id_to_(unique_id_buf);
+
+  if (global_mqtt_client->get_discovery_info().object_id_generator == MQTT_DEVICE_NAME_OBJECT_ID_GENERATOR) {
+    char object_id_buf[OBJECT_ID_MAX_LEN];
+    StringRef object_id = this->get_default_object_id_to_(object_id_buf);
+    // node_name (max 31) + "_" (1) + object_id (max 128) + null
+    char object_id_full[ESPHOME_DEVICE_NAME_MAX_LEN + 1 + OBJECT_ID_MAX_LEN + 1];
+    buf_append_printf(object_id_full, sizeof(object_id_full), 0, "%s_%s", App.get_name().c_str(),
+                      object_id.c_str());
+    root[MQTT_OBJECT_ID] = object_id_full;
+  }
+
+#ifdef USE_MQTT_ABBREVIATIONS
+  this->apply_topic_base_(root);
 #endif
-        if (node_area[0] != '\0') {
-          device_info[MQTT_DEVICE_SUGGESTED_AREA] = node_area;
-        }
-
-        device_info[MQTT_DEVICE_CONNECTIONS][0][0] = "mac";
-        device_info[MQTT_DEVICE_CONNECTIONS][0][1] = mac;
-      },
-      this->qos_, discovery_info.retain);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
 }
 
+#ifdef USE_MQTT_ABBREVIATIONS
+/// Returns the topic value of a discovery entry if it starts with base, nullptr otherwise.
+static const char *topic_under_base(JsonPair kv, StringRef base) {
+  // Abbreviated topic keys all end in "_t" ("stat_t", "cmd_t", "avty_t", ...)
+  JsonString key = kv.key();
+  if (key.size() < 2 || key.c_str()[key.size() - 2] != '_' || key.c_str()[key.size() - 1] != 't')
+    return nullptr;
+  const char *topic = kv.value().as<const char *>();
+  if (topic == nullptr || strncmp(topic, base.c_str(), base.size()) != 0)
+    return nullptr;
+  return topic;
+}
+
+void MQTTComponent::apply_topic_base_(JsonObject root) const {
+  // Home Assistant expands a leading '~' in topic values to the value of the "~" key. All default topics
+  // share <topic_prefix>/<component_type>/<object_id>/, so send that once instead of in every topic.
+  char base_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+  StringRef base = this->get_default_topic_for_to_(base_buf, "", 0);
+  if (base.empty())
+    return;
+
+  uint8_t matches = 0;
+  for (JsonPair kv : root) {
+    if (topic_under_base(kv, base) != nullptr)
+      matches++;
+  }
+  // A single topic gains nothing from the extra "~" key
+  if (matches < 2)
+    return;
+
+  for (JsonPair kv : root) {
+    const char *topic = topic_under_base(kv, base);
+    if (topic == nullptr)
+      continue;
+    // Keep the '/' that follows the base: "~/state"
+    char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+    topic_buf[0] = '~';
+    strncpy(topic_buf + 1, topic + base.size() - 1, sizeof(topic_buf) - 2);
+    topic_buf[sizeof(topic_buf) - 1] = '\0';
+    kv.value().set(topic_buf);
+  }
+  base_buf[base.size() - 1] = '\0';  // drop the trailing '/'
+  root[MQTT_TOPIC_BASE] = base_buf;
+}
+#endif
+
 uint8_t MQTTComponent::get_qos() const { return this->qos_; }
 
 bool MQTTComponent::get_retain() const { return this->retain_; }
@@ -353,6 +459,13 @@ void MQTTComponent::subscribe(const std::string &topic, mqtt_callback_t callback
 }
 
 void MQTTComponent::subscribe_json(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos) {
+#ifdef USE_MQTT_MSGPACK
+  // Commands of discovered entities come from Home Assistant as JSON text
+  if (this->is_discovery_enabled()) {
+    global_mqtt_client->subscribe_json_text(topic, callback, qos);
+    return;
+  }
+#endif
   global_mqtt_client->subscribe_json(topic, callback, qos);
 }
 
@@ -380,36 +493,53 @@ void MQTTComponent::call_setup() {
 
   global_mqtt_client->register_mqtt_component(this);
 
-  if (!this->is_connected_())
-    return;
-
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
-  if (!this->send_initial_state()) {
-    this->schedule_resend_state();
+#if defined(USE_MQTT_SKIP_UNCHANGED) && !defined(USE_MQTT_DEVICE_DISCOVERY)
+  if (global_mqtt_client->is_skip_unchanged_persisted() && this->is_discovery_enabled()) {
+    // Keyed by the discovery topic, which is unique per entity and stable across firmware updates
+    const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
+    char discovery_topic_buf[MQTT_DISCOVERY_TOPIC_MAX_LEN];
+    StringRef discovery_topic = this->get_discovery_topic_to_(discovery_topic_buf, discovery_info);
+    this->discovery_pref_ = global_preferences->make_preference<uint32_t>(fnv1_hash(discovery_topic.c_str()));
+    this->discovery_pref_.load(&this->discovery_hash_);
   }
+#endif
+
+  // Setup only registers: discovery and the initial state go out from the client's time-budgeted resend pass,
+  // so a large config never blocks the setup of later components. check_connected() reschedules on connect.
+  this->schedule_resend_state();
 }
 
-void MQTTComponent::process_resend() {
-  // Called by MQTTClientComponent when connected to process pending resends
-  // Note: is_internal() check not needed - internal components are never registered
+// Called by MQTTClientComponent when connected to process pending resends
+// Note: is_internal() check not needed - internal components are never registered
+void MQTTComponent::process_state_resend() {
   if (!this->resend_state_)
     return;
-
   this->resend_state_ = false;
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  // Every retained state published since the last full send was accepted and the broker kept our session
+  if (!this->state_dirty_ && this->retain_ && global_mqtt_client->is_session_present())
+    return;
+#endif
   if (!this->send_initial_state()) {
-    this->schedule_resend_state();
+    this->resend_state_ = true;
+    return;
+  }
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  this->state_dirty_ = false;
+#endif
+}
+void MQTTComponent::process_discovery_resend() {
+  if (!this->resend_discovery_)
+    return;
+  this->resend_discovery_ = false;
+  if (this->is_discovery_enabled() && !this->send_discovery_()) {
+    this->resend_discovery_ = true;
   }
 }
-void MQTTComponent::schedule_resend_state() { this->resend_state_ = true; }
+void MQTTComponent::schedule_resend_state() {
+  this->resend_state_ = true;
+  this->resend_discovery_ = true;
+}
 bool MQTTComponent::is_connected_() const { return global_mqtt_client->is_connected(); }
 
 // Pull these properties from EntityBase if not overridden
@@ -9,6 +9,7 @@
 #include "esphome/core/automation.h"
 #include "esphome/core/component.h"
 #include "esphome/core/entity_base.h"
+#include "esphome/core/preferences.h"
 #include "esphome/core/progmem.h"
 #include "esphome/core/string_ref.h"
 #include "mqtt_client.h"
@@ -37,8 +38,51 @@ static constexpr size_t MQTT_DISCOVERY_PREFIX_MAX_LEN = 64;  // Validated in Pyt
 static constexpr size_t MQTT_DISCOVERY_TOPIC_MAX_LEN = MQTT_DISCOVERY_PREFIX_MAX_LEN + 1 + MQTT_COMPONENT_TYPE_MAX_LEN +
                                                        1 + ESPHOME_DEVICE_NAME_MAX_LEN + 1 + OBJECT_ID_MAX_LEN + 7 + 1;
 
+/// FNV-1a over a payload buffer, used to fingerprint published state payloads.
+inline uint32_t mqtt_payload_hash(const char *payload, size_t len) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<uint8_t>(payload[i]);
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+/** Fingerprints of the last payload published on each state sub-topic of a component.
+ *
+ * Components that split their state over several topics (climate, fan, cover, ...) use this to publish
+ * only the sub-topics whose payload actually changed. invalidate() forces the next publish to go out in
+ * full, which is done whenever the initial state is (re)sent, e.g. after a reconnect.
+ *
+ * @tparam N The number of sub-topics, at most 32.
+ */
+template<size_t N> class MQTTStateSnapshot {
+  static_assert(N <= 32, "MQTTStateSnapshot supports at most 32 sub-topics");
+
+ public:
+  /// Forget all fingerprints so that every sub-topic is published again.
+  void invalidate() { this->valid_ = 0; }
+  /// Whether the payload with this fingerprint was the last one published on sub-topic index.
+  bool matches(size_t index, uint32_t hash) const {
+    return ((this->valid_ >> index) & 1) != 0 && this->hashes_[index] == hash;
+  }
+  void store(size_t index, uint32_t hash) {
+    this->hashes_[index] = hash;
+    this->valid_ |= uint32_t(1) << index;
+  }
+
+ protected:
+  uint32_t hashes_[N]{};
+  uint32_t valid_{0};
+};
+
+/// Max length of a discovery unique_id: "ESP" + component type + object id + null (the MAC based form is shorter).
+static constexpr size_t MQTT_UNIQUE_ID_MAX_LEN = 3 + MQTT_COMPONENT_TYPE_MAX_LEN + OBJECT_ID_MAX_LEN + 1;
+
 class MQTTComponent;  // Forward declaration
 void log_mqtt_component(const char *tag, MQTTComponent *obj, bool state_topic, bool command_topic);
+/// Fill the Home Assistant discovery device block describing this node.
+void build_mqtt_device_info(JsonObject device_info);
 
 #define LOG_MQTT_COMPONENT(state_topic, command_topic) log_mqtt_component(TAG, this, state_topic, command_topic)
 
@@ -103,6 +147,11 @@ class MQTTComponent : public Component {
 
   virtual bool send_initial_state() = 0;
 
+#ifdef USE_MQTT_BURST
+  /// Whether the entity has a state to publish yet. Burst mode waits for every entity before it completes.
+  virtual bool has_initial_state() const { return true; }
+#endif
+
   /// Returns cached is_internal result (computed once during setup).
   bool is_internal() const { return this->is_internal_; }
 
@@ -144,14 +193,24 @@ class MQTTComponent : public Component {
   void set_availability(std::string topic, std::string payload_available, std::string payload_not_available);
   void disable_availability();
 
-  /// Internal method for the MQTT client base to schedule a resend of the state on reconnect.
+  /// Internal method for the MQTT client base to schedule a resend of discovery and state on reconnect.
   void schedule_resend_state();
 
   /// Check if a resend is pending (called by MQTTClientComponent to rate-limit work)
-  bool is_resend_pending() const { return this->resend_state_; }
-
-  /// Process pending resend if needed (called by MQTTClientComponent)
-  void process_resend();
+  bool is_state_resend_pending() const { return this->resend_state_; }
+  bool is_discovery_resend_pending() const { return this->resend_discovery_; }
+
+  /// Resend the state if pending, re-arming it on failure.
+  void process_state_resend();
+  /// Resend discovery if pending, re-arming it on failure.
+  void process_discovery_resend();
+
+#ifdef USE_MQTT_DEVICE_DISCOVERY
+  /// Add this entity to the "components" object of a device-based discovery payload (called by MQTTClientComponent).
+  void add_to_device_discovery(JsonObject components);
+  /// Publish a retained payload on this entity's own discovery topic, used before device mode to migrate or clean it.
+  bool publish_entity_discovery(const char *payload);
+#endif
 
   /** Send a MQTT message.
    *
@@ -233,6 +292,8 @@ class MQTTComponent : public Component {
 #endif
 
   /** Construct and send a JSON MQTT message.
+   *
+   * With payload_format msgpack only entities hidden from discovery publish MessagePack.
    *
    * @param topic The topic.
    * @param f The Json Message builder.
@@ -273,6 +334,43 @@ class MQTTComponent : public Component {
   void subscribe_json(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos = 0);
 
  protected:
+  /** Send a MQTT message only if the payload differs from the last one published on this sub-topic.
+   *
+   * @param snapshot The component's snapshot of last-published payloads.
+   * @param index The sub-topic slot in the snapshot.
+   * @param topic The topic as StringRef (for use with get_*_topic_to()).
+   * @param payload The payload buffer.
+   * @param payload_length The length of the payload.
+   * @return true if the payload was published or unchanged, false if publishing failed.
+   */
+  template<size_t N>
+  bool publish_if_changed_(MQTTStateSnapshot<N> &snapshot, size_t index, StringRef topic, const char *payload,
+                           size_t payload_length) {
+    uint32_t hash = mqtt_payload_hash(payload, payload_length);
+    if (snapshot.matches(index, hash))
+      return true;
+    if (!this->publish(topic, payload, payload_length))
+      return false;
+    snapshot.store(index, hash);
+    return true;
+  }
+
+  template<size_t N>
+  bool publish_if_changed_(MQTTStateSnapshot<N> &snapshot, size_t index, StringRef topic, const char *payload) {
+    return this->publish_if_changed_(snapshot, index, topic, payload, strlen(payload));
+  }
+
+#ifdef USE_ESP8266
+  template<size_t N>
+  bool publish_if_changed_(MQTTStateSnapshot<N> &snapshot, size_t index, StringRef topic, ProgmemStr payload) {
+    // On ESP8266, ProgmemStr is __FlashStringHelper* - need to copy from flash
+    char buf[64];
+    strncpy_P(buf, reinterpret_cast<const char *>(payload), sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    return this->publish_if_changed_(snapshot, index, topic, buf, strlen(buf));
+  }
+#endif
+
   /// Helper method to get the discovery topic for this component into a buffer.
   StringRef get_discovery_topic_to_(std::span<char, MQTT_DISCOVERY_TOPIC_MAX_LEN> buf,
                                     const MQTTDiscoveryInfo &discovery_info) const;
@@ -327,6 +425,27 @@ class MQTTComponent : public Component {
 
   /// Internal method to start sending discovery info, this will call send_discovery().
   bool send_discovery_();
+  /// Build the full per-entity discovery payload: the entity fields plus the device block.
+  void build_discovery_(JsonObject root);
+  /// Build the entity part of the discovery payload: the common fields plus everything added by send_discovery().
+  void build_entity_discovery_(JsonObject root);
+  /// Get the discovery unique_id of this component into a buffer.
+  StringRef get_unique_id_to_(std::span<char, MQTT_UNIQUE_ID_MAX_LEN> buf) const;
+#ifdef USE_MQTT_ABBREVIATIONS
+  /// Replace the default topic prefix shared by the topics in a discovery payload with the "~" base topic.
+  void apply_topic_base_(JsonObject root) const;
+#endif
+
+  /// Record the outcome of a publish on one of this component's topics, a failure schedules a state resend.
+  bool track_publish_(bool success) {
+    if (!success) {
+      this->resend_state_ = true;
+#ifdef USE_MQTT_SKIP_UNCHANGED
+      this->state_dirty_ = true;
+#endif
+    }
+    return success;
+  }
 
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
@@ -345,7 +464,14 @@ class MQTTComponent : public Component {
   bool retain_ : 1 {true};
   bool discovery_enabled_ : 1 {true};
   bool resend_state_ : 1 {false};
+  bool resend_discovery_ : 1 {false};
   bool is_internal_ : 1 {false};  ///< Cached result of compute_is_internal_(), set during setup
+#ifdef USE_MQTT_SKIP_UNCHANGED
+  bool state_dirty_ : 1 {true};  ///< A publish failed since the initial state was last sent in full
+
+  uint32_t discovery_hash_{0};  ///< Hash of the last discovery payload accepted by the broker, 0 if unknown
+  ESPPreferenceObject discovery_pref_;
+#endif
 
   /// Compute is_internal status based on topics and entity state.
   /// Called once during setup to cache the result.
@@ -0,0 +1,98 @@
+#include "mqtt_compression.h"
+
+#ifdef USE_MQTT_COMPRESSION
+
+namespace esphome::mqtt {
+
+namespace {
+
+/// MSB-first bit writer over a bounded output buffer.
+class BitWriter {
+ public:
+  BitWriter(uint8_t *out, size_t cap) : out_(out), cap_(cap) {}
+
+  /// Append the low `count` bits of `value`. Returns false once the output buffer is full.
+  bool write(uint16_t value, uint8_t count) {
+    while (count > 0) {
+      count--;
+      if (value & (1u << count))
+        this->current_ |= this->mask_;
+      this->mask_ >>= 1;
+      if (this->mask_ == 0 && !this->flush_byte_())
+        return false;
+    }
+    return true;
+  }
+
+  /// Write out a partially filled last byte (zero padded) and return the total length, 0 on overflow.
+  size_t finish() {
+    if (this->mask_ != 0x80 && !this->flush_byte_())
+      return 0;
+    return this->len_;
+  }
+
+ protected:
+  bool flush_byte_() {
+    if (this->len_ >= this->cap_)
+      return false;
+    this->out_[this->len_++] = this->current_;
+    this->current_ = 0;
+    this->mask_ = 0x80;
+    return true;
+  }
+
+  uint8_t *out_;
+  size_t cap_;
+  size_t len_{0};
+  uint8_t current_{0};
+  uint8_t mask_{0x80};
+};
+
+}  // namespace
+
+size_t heatshrink_compress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_cap, uint8_t window_bits,
+                           uint8_t lookahead_bits) {
+  const size_t window = size_t(1) << window_bits;
+  const size_t max_match = size_t(1) << lookahead_bits;
+  // A back-reference costs 1 + window_bits + lookahead_bits bits, a literal 9 bits per byte
+  const size_t break_even = (1 + window_bits + lookahead_bits) / 9;
+  BitWriter writer(out, out_cap);
+
+  size_t pos = 0;
+  while (pos < in_len) {
+    const size_t limit = (in_len - pos < max_match) ? in_len - pos : max_match;
+    const size_t start = pos > window ? pos - window : 0;
+    size_t best_len = 0;
+    size_t best_offset = 0;
+    // Scan backwards so the nearest match wins ties
+    for (size_t cand = pos; cand-- > start;) {
+      if (in[cand] != in[pos] || in[cand + best_len] != in[pos + best_len])
+        continue;
+      size_t len = 1;
+      while (len < limit && in[cand + len] == in[pos + len])
+        len++;
+      if (len > best_len) {
+        best_len = len;
+        best_offset = pos - cand;
+        if (len == limit)
+          break;
+      }
+    }
+
+    if (best_len > break_even) {
+      if (!writer.write(0, 1) || !writer.write(best_offset - 1, window_bits) ||
+          !writer.write(best_len - 1, lookahead_bits))
+        return 0;
+      pos += best_len;
+    } else {
+      if (!writer.write(1, 1) || !writer.write(in[pos], 8))
+        return 0;
+      pos++;
+    }
+  }
+  return writer.finish();
+}
+
+}  // namespace esphome::mqtt
+
+#endif  // USE_MQTT_COMPRESSION
@@ -0,0 +1,42 @@
+#pragma once
+#include "esphome/core/defines.h"
+#ifdef USE_MQTT_COMPRESSION
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::mqtt {
+
+/// Smallest supported heatshrink window (2^4 = 16 bytes of history).
+static constexpr uint8_t HEATSHRINK_MIN_WINDOW_BITS = 4;
+/// Largest supported heatshrink window (2^8 = 256 bytes of history). The match search scans the whole window for
+/// every input byte, larger windows cost more time inside publish() than they save bytes (tests/host bench).
+static constexpr uint8_t HEATSHRINK_MAX_WINDOW_BITS = 8;
+/// Smallest supported lookahead (2^3 = 8 bytes per back-reference).
+static constexpr uint8_t HEATSHRINK_MIN_LOOKAHEAD_BITS = 3;
+
+/** Compress a buffer into the heatshrink LZSS bitstream format.
+ *
+ * The output can be decoded by the reference heatshrink decoder (or its Python
+ * binding) configured with the same window_bits/lookahead_bits. The encoder
+ * keeps no state between calls: the history window is the input buffer itself,
+ * so the only memory used is the caller-provided output buffer.
+ *
+ * Bitstream, most significant bit first:
+ *   literal:        1, <8 bit byte>
+ *   back-reference: 0, <window_bits: offset - 1>, <lookahead_bits: length - 1>
+ * The last byte is zero padded.
+ *
+ * @param in Uncompressed data.
+ * @param in_len Length of in.
+ * @param out Output buffer.
+ * @param out_cap Capacity of out, compression stops early if it would be exceeded.
+ * @param window_bits log2 of the history window, HEATSHRINK_MIN_WINDOW_BITS..HEATSHRINK_MAX_WINDOW_BITS.
+ * @param lookahead_bits log2 of the maximum match length, HEATSHRINK_MIN_LOOKAHEAD_BITS..window_bits - 1.
+ * @return Number of bytes written to out, or 0 if the result did not fit in out_cap.
+ */
+size_t heatshrink_compress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_cap, uint8_t window_bits,
+                           uint8_t lookahead_bits);
+
+}  // namespace esphome::mqtt
+
+#endif  // USE_MQTT_COMPRESSION
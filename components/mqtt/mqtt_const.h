@@ -66,6 +66,7 @@
   X(MQTT_COMMAND_RETAIN, "ret", "retain") \
   X(MQTT_COMMAND_TEMPLATE, "cmd_tpl", "command_template") \
   X(MQTT_COMMAND_TOPIC, "cmd_t", "command_topic") \
+  X(MQTT_COMPONENTS, "cmps", "components") \
   X(MQTT_CONFIGURATION_URL, "cu", "configuration_url") \
   X(MQTT_CURRENT_HUMIDITY_TEMPLATE, "curr_hum_tpl", "current_humidity_template") \
   X(MQTT_CURRENT_HUMIDITY_TOPIC, "curr_hum_t", "current_humidity_topic") \
@@ -84,6 +85,7 @@
   X(MQTT_DEVICE_HW_VERSION, "hw", "hw_version") \
   X(MQTT_DIRECTION_COMMAND_TOPIC, "dir_cmd_t", "direction_command_topic") \
   X(MQTT_DIRECTION_STATE_TOPIC, "dir_stat_t", "direction_state_topic") \
+  X(MQTT_DIRECTION_VALUE_TEMPLATE, "dir_val_tpl", "direction_value_template") \
   X(MQTT_DOCKED_TEMPLATE, "dock_tpl", "docked_template") \
   X(MQTT_DOCKED_TOPIC, "dock_t", "docked_topic") \
   X(MQTT_EFFECT_COMMAND_TOPIC, "fx_cmd_t", "effect_command_topic") \
@@ -143,6 +145,8 @@
   X(MQTT_ON_COMMAND_TYPE, "on_cmd_type", "on_command_type") \
   X(MQTT_OPTIMISTIC, "opt", "optimistic") \
   X(MQTT_OPTIONS, "ops", "options") \
+  X(MQTT_ORIGIN, "o", "origin") \
+  X(MQTT_ORIGIN_SUPPORT_URL, "url", "support_url") \
   X(MQTT_OSCILLATION_COMMAND_TEMPLATE, "osc_cmd_tpl", "oscillation_command_template") \
   X(MQTT_OSCILLATION_COMMAND_TOPIC, "osc_cmd_t", "oscillation_command_topic") \
   X(MQTT_OSCILLATION_STATE_TOPIC, "osc_stat_t", "oscillation_state_topic") \
@@ -189,6 +193,7 @@
   X(MQTT_PERCENTAGE_COMMAND_TOPIC, "pct_cmd_t", "percentage_command_topic") \
   X(MQTT_PERCENTAGE_STATE_TOPIC, "pct_stat_t", "percentage_state_topic") \
   X(MQTT_PERCENTAGE_VALUE_TEMPLATE, "pct_val_tpl", "percentage_value_template") \
+  X(MQTT_PLATFORM, "p", "platform") \
   X(MQTT_POSITION_CLOSED, "pos_clsd", "position_closed") \
   X(MQTT_POSITION_OPEN, "pos_open", "position_open") \
   X(MQTT_POSITION_TEMPLATE, "pos_tpl", "position_template") \
@@ -279,6 +284,7 @@
   X(MQTT_TILT_STATUS_TEMPLATE, "tilt_status_tpl", "tilt_status_template") \
   X(MQTT_TILT_STATUS_TOPIC, "tilt_status_t", "tilt_status_topic") \
   X(MQTT_TOPIC, "t", "topic") \
+  X(MQTT_TOPIC_BASE, "~", "~") \
   X(MQTT_UNIQUE_ID, "uniq_id", "unique_id") \
   X(MQTT_UNIT_OF_MEASUREMENT, "unit_of_meas", "unit_of_measurement") \
   X(MQTT_VALUE_TEMPLATE, "val_tpl", "value_template") \
@@ -132,7 +132,11 @@ void MQTTCoverComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryConf
 MQTT_COMPONENT_TYPE(MQTTCoverComponent, "cover")
 const EntityBase *MQTTCoverComponent::get_entity() const { return this->cover_; }
 
-bool MQTTCoverComponent::send_initial_state() { return this->publish_state(); }
+bool MQTTCoverComponent::send_initial_state() {
+  // Initial state (also sent on reconnect) always publishes every sub-topic
+  this->state_snapshot_.invalidate();
+  return this->publish_state();
+}
 bool MQTTCoverComponent::publish_state() {
   auto traits = this->cover_->get_traits();
   char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
@@ -152,22 +156,24 @@ bool MQTTCoverComponent::publish_state() {
     });
   }
 #endif
+  // Only sub-topics whose payload changed since the last publish are sent, see send_initial_state()
+  auto &snapshot = this->state_snapshot_;
   bool success = true;
   if (traits.get_supports_position()) {
     char pos[VALUE_ACCURACY_MAX_LEN];
     size_t len = value_accuracy_to_buf(pos, roundf(this->cover_->position * 100), 0);
-    if (!this->publish(this->get_position_state_topic_to(topic_buf), pos, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_POSITION, this->get_position_state_topic_to(topic_buf), pos, len))
       success = false;
   }
   if (traits.get_supports_tilt()) {
     char pos[VALUE_ACCURACY_MAX_LEN];
     size_t len = value_accuracy_to_buf(pos, roundf(this->cover_->tilt * 100), 0);
-    if (!this->publish(this->get_tilt_state_topic_to(topic_buf), pos, len))
+    if (!this->publish_if_changed_(snapshot, SLOT_TILT, this->get_tilt_state_topic_to(topic_buf), pos, len))
       success = false;
   }
-  if (!this->publish(this->get_state_topic_to_(topic_buf),
-                     cover_state_to_mqtt_str(this->cover_->current_operation, this->cover_->position,
-                                             traits.get_supports_position())))
+  if (!this->publish_if_changed_(snapshot, SLOT_STATE, this->get_state_topic_to_(topic_buf),
+                                 cover_state_to_mqtt_str(this->cover_->current_operation, this->cover_->position,
+                                                         traits.get_supports_position())))
     success = false;
   return success;
 }
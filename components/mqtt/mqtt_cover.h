@@ -35,7 +35,16 @@ class MQTTCoverComponent final : public mqtt::MQTTComponent {
   const char *component_type() const override;
   const EntityBase *get_entity() const override;
 
+  /// State sub-topic slots for delta publishing.
+  enum StateSlot : uint8_t {
+    SLOT_STATE = 0,
+    SLOT_POSITION,
+    SLOT_TILT,
+    SLOT_COUNT,
+  };
+
   cover::Cover *cover_;
+  MQTTStateSnapshot<SLOT_COUNT> state_snapshot_;
 #ifdef USE_MQTT_COVER_JSON
   bool use_json_format_{false};
 #endif
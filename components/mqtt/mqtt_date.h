@@ -27,6 +27,9 @@ class MQTTDateComponent final : public mqtt::MQTTComponent {
   void send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) override;
 
   bool send_initial_state() override;
+#ifdef USE_MQTT_BURST
+  bool has_initial_state() const override { return this->date_->has_state(); }
+#endif
 
   bool publish_state(uint16_t year, uint8_t month, uint8_t day);
 
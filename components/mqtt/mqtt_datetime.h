@@ -27,6 +27,9 @@ class MQTTDateTimeComponent final : public mqtt::MQTTComponent {
   void send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) override;
 
   bool send_initial_state() override;
+#ifdef USE_MQTT_BURST
+  bool has_initial_state() const override { return this->datetime_->has_state(); }
+#endif
 
   bool publish_state(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
 
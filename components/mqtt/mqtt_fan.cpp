@@ -127,6 +127,11 @@ void MQTTFanComponent::setup() {
 void MQTTFanComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "MQTT Fan '%s': ", this->state_->get_name().c_str());
   LOG_MQTT_COMPONENT(true, true);
+#ifdef USE_MQTT_FAN_JSON
+  if (this->use_json_format_) {
+    ESP_LOGCONFIG(TAG, "  JSON State Payload: YES");
+  }
+#endif
   if (this->state_->get_traits().supports_direction()) {
     ESP_LOGCONFIG(TAG,
                   "  Direction State Topic: '%s'\n"
@@ -147,10 +152,39 @@ void MQTTFanComponent::dump_config() {
   }
 }
 
-bool MQTTFanComponent::send_initial_state() { return this->publish_state(); }
+bool MQTTFanComponent::send_initial_state() {
+  // Initial state (also sent on reconnect) always publishes every sub-topic
+  this->state_snapshot_.invalidate();
+  return this->publish_state();
+}
 
 void MQTTFanComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) {
-  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
+  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
+#ifdef USE_MQTT_FAN_JSON
+  if (this->use_json_format_) {
+    // JSON mode: all state published to state_topic as JSON, use templates to extract
+    char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+    StringRef state_topic = this->get_state_topic_to_(topic_buf);
+    root[MQTT_STATE_VALUE_TEMPLATE] = ESPHOME_F("{{ value_json.state }}");
+    if (this->state_->get_traits().supports_direction()) {
+      root[MQTT_DIRECTION_COMMAND_TOPIC] = this->get_direction_command_topic();
+      root[MQTT_DIRECTION_STATE_TOPIC] = state_topic;
+      root[MQTT_DIRECTION_VALUE_TEMPLATE] = ESPHOME_F("{{ value_json.direction }}");
+    }
+    if (this->state_->get_traits().supports_oscillation()) {
+      root[MQTT_OSCILLATION_COMMAND_TOPIC] = this->get_oscillation_command_topic();
+      root[MQTT_OSCILLATION_STATE_TOPIC] = state_topic;
+      root[MQTT_OSCILLATION_VALUE_TEMPLATE] = ESPHOME_F("{{ value_json.oscillation }}");
+    }
+    if (this->state_->get_traits().supports_speed()) {
+      root[MQTT_PERCENTAGE_COMMAND_TOPIC] = this->get_speed_level_command_topic();
+      root[MQTT_PERCENTAGE_STATE_TOPIC] = state_topic;
+      root[MQTT_PERCENTAGE_VALUE_TEMPLATE] = ESPHOME_F("{{ value_json.speed_level }}");
+      root[MQTT_SPEED_RANGE_MAX] = this->state_->get_traits().supported_speed_count();
+    }
+    return;
+  }
+#endif
   if (this->state_->get_traits().supports_direction()) {
     root[MQTT_DIRECTION_COMMAND_TOPIC] = this->get_direction_command_topic();
     root[MQTT_DIRECTION_STATE_TOPIC] = this->get_direction_state_topic();
@@ -164,28 +198,56 @@ void MQTTFanComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryConfig
     root[MQTT_PERCENTAGE_STATE_TOPIC] = this->get_speed_level_state_topic();
     root[MQTT_SPEED_RANGE_MAX] = this->state_->get_traits().supported_speed_count();
   }
+  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
 }
 bool MQTTFanComponent::publish_state() {
   char topic_buf[MQTT_DEFAULT_TOPIC_MAX_LEN];
+#ifdef USE_MQTT_FAN_JSON
+  if (this->use_json_format_) {
+    auto traits = this->state_->get_traits();
+    auto message = json::build_json([this, &traits](JsonObject root) {
+      // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
+      root[ESPHOME_F("state")] = this->state_->state ? "ON" : "OFF";
+      if (traits.supports_direction()) {
+        root[ESPHOME_F("direction")] = fan_direction_to_mqtt_str(this->state_->direction);
+      }
+      if (traits.supports_oscillation()) {
+        root[ESPHOME_F("oscillation")] = fan_oscillation_to_mqtt_str(this->state_->oscillating);
+      }
+      if (traits.supports_speed()) {
+        root[ESPHOME_F("speed_level")] = this->state_->speed;
+      }
+      // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+    });
+    ESP_LOGD(TAG, "'%s' Sending state %s.", this->state_->get_name().c_str(), message.c_str());
+    // The whole document occupies the first snapshot slot, so unchanged state is still not republished
+    return this->publish_if_changed_(this->state_snapshot_, SLOT_STATE, this->get_state_topic_to_(topic_buf),
+                                     message.c_str(), message.size());
+  }
+#endif
+  // Only sub-topics whose payload changed since the last publish are sent, see send_initial_state()
+  auto &snapshot = this->state_snapshot_;
   const char *state_s = this->state_->state ? "ON" : "OFF";
   ESP_LOGD(TAG, "'%s' Sending state %s.", this->state_->get_name().c_str(), state_s);
-  this->publish(this->get_state_topic_to_(topic_buf), state_s);
+  this->publish_if_changed_(snapshot, SLOT_STATE, this->get_state_topic_to_(topic_buf), state_s);
   bool failed = false;
   if (this->state_->get_traits().supports_direction()) {
-    bool success = this->publish(this->get_direction_state_topic_to(topic_buf),
-                                 fan_direction_to_mqtt_str(this->state_->direction));
+    bool success = this->publish_if_changed_(snapshot, SLOT_DIRECTION, this->get_direction_state_topic_to(topic_buf),
+                                             fan_direction_to_mqtt_str(this->state_->direction));
     failed = failed || !success;
   }
   if (this->state_->get_traits().supports_oscillation()) {
-    bool success = this->publish(this->get_oscillation_state_topic_to(topic_buf),
-                                 fan_oscillation_to_mqtt_str(this->state_->oscillating));
+    bool success =
+        this->publish_if_changed_(snapshot, SLOT_OSCILLATION, this->get_oscillation_state_topic_to(topic_buf),
+                                  fan_oscillation_to_mqtt_str(this->state_->oscillating));
     failed = failed || !success;
   }
   auto traits = this->state_->get_traits();
   if (traits.supports_speed()) {
     char buf[12];
     size_t len = buf_append_printf(buf, sizeof(buf), 0, "%d", this->state_->speed);
-    bool success = this->publish(this->get_speed_level_state_topic_to(topic_buf), buf, len);
+    bool success = this->publish_if_changed_(snapshot, SLOT_SPEED_LEVEL,
+                                             this->get_speed_level_state_topic_to(topic_buf), buf, len);
     failed = failed || !success;
   }
   return !failed;
@@ -23,6 +23,10 @@ class MQTTFanComponent final : public mqtt::MQTTComponent {
   MQTT_COMPONENT_CUSTOM_TOPIC(speed, command)
   MQTT_COMPONENT_CUSTOM_TOPIC(speed, state)
 
+#ifdef USE_MQTT_FAN_JSON
+  void set_use_json_format(bool use_json_format) { this->use_json_format_ = use_json_format; }
+#endif
+
   void send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) override;
 
   // ========== INTERNAL METHODS ==========
@@ -43,7 +47,20 @@ class MQTTFanComponent final : public mqtt::MQTTComponent {
  protected:
   const EntityBase *get_entity() const override;
 
+  /// State sub-topic slots for delta publishing.
+  enum StateSlot : uint8_t {
+    SLOT_STATE = 0,
+    SLOT_DIRECTION,
+    SLOT_OSCILLATION,
+    SLOT_SPEED_LEVEL,
+    SLOT_COUNT,
+  };
+
   fan::Fan *state_;
+  MQTTStateSnapshot<SLOT_COUNT> state_snapshot_;
+#ifdef USE_MQTT_FAN_JSON
+  bool use_json_format_{false};
+#endif
 };
 
 }  // namespace esphome::mqtt
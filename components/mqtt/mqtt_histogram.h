@@ -0,0 +1,64 @@
+#pragma once
+#include "esphome/core/defines.h"
+#if defined(USE_MQTT_TELEMETRY) || defined(USE_MQTT_LATENCY_PROBE)
+#include <cstdint>
+
+namespace esphome::mqtt {
+
+/** Fixed-size histogram of durations with power of two buckets.
+ *
+ * Bucket 0 counts zero, bucket i counts values in [2^(i-1), 2^i). Percentiles are reported as the upper
+ * bound of the bucket they fall in (capped at the largest value seen), exact to within a factor of two
+ * without storing samples. When a bucket would overflow all counts are halved, so old samples fade out.
+ */
+class MQTTHistogram {
+ public:
+  static constexpr uint8_t BUCKETS = 24;  ///< Last bucket holds everything from 2^22 on
+
+  void record(uint32_t value) {
+    uint8_t bucket = 0;
+    while (bucket < BUCKETS - 1 && (value >> bucket) != 0)
+      bucket++;
+    if (this->counts_[bucket] == UINT16_MAX)
+      this->halve_();
+    this->counts_[bucket]++;
+    this->count_++;
+    if (value > this->max_)
+      this->max_ = value;
+  }
+
+  /// Value below which pct percent of the samples fall, 0 without samples.
+  uint32_t percentile(uint8_t pct) const {
+    const uint32_t rank = (this->count_ * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < BUCKETS; bucket++) {
+      seen += this->counts_[bucket];
+      if (seen >= rank && seen > 0) {
+        if (bucket == BUCKETS - 1)
+          return this->max_;
+        const uint32_t upper = (1UL << bucket) - 1;
+        return upper < this->max_ ? upper : this->max_;
+      }
+    }
+    return this->max_;
+  }
+
+  uint32_t max() const { return this->max_; }
+  uint32_t count() const { return this->count_; }
+
+ protected:
+  void halve_() {
+    this->count_ = 0;
+    for (auto &count : this->counts_) {
+      count /= 2;
+      this->count_ += count;
+    }
+  }
+
+  uint16_t counts_[BUCKETS]{};
+  uint32_t count_{0};
+  uint32_t max_{0};
+};
+
+}  // namespace esphome::mqtt
+#endif
@@ -20,6 +20,15 @@ using namespace esphome::sensor;
 MQTTSensorComponent::MQTTSensorComponent(Sensor *sensor) : sensor_(sensor) {}
 
 void MQTTSensorComponent::setup() {
+#ifdef USE_MQTT_SENSOR_BATCH
+  if (this->batch_size_ > 0) {
+    this->batch_ = make_unique<BatchSample[]>(this->batch_size_);
+    this->batch_payload_ = make_unique<char[]>(batch_payload_size(this->batch_size_));
+    this->batch_topic_ = this->get_state_topic_() + "/batch";
+    this->sensor_->add_on_state_callback([this](float state) { this->add_batch_sample_(state); });
+    return;
+  }
+#endif
   this->sensor_->add_on_state_callback([this](float state) { this->publish_state(state); });
 }
 
@@ -29,6 +38,15 @@ void MQTTSensorComponent::dump_config() {
     ESP_LOGCONFIG(TAG, "  Expire After: %" PRIu32 "s", this->get_expire_after() / 1000);
   }
   LOG_MQTT_COMPONENT(true, false);
+#ifdef USE_MQTT_SENSOR_BATCH
+  if (this->batch_size_ > 0) {
+    ESP_LOGCONFIG(TAG,
+                  "  Batch Topic: '%s'\n"
+                  "  Batch Size: %u\n"
+                  "  Batch Flush Interval: %" PRIu32 "ms",
+                  this->batch_topic_.c_str(), this->batch_size_, this->batch_flush_interval_);
+  }
+#endif
 }
 
 MQTT_COMPONENT_TYPE(MQTTSensorComponent, "sensor")
@@ -41,6 +59,12 @@ uint32_t MQTTSensorComponent::get_expire_after() const {
 }
 void MQTTSensorComponent::set_expire_after(uint32_t expire_after) { this->expire_after_ = expire_after; }
 void MQTTSensorComponent::disable_expire_after() { this->expire_after_ = 0; }
+#ifdef USE_MQTT_SENSOR_BATCH
+void MQTTSensorComponent::set_batch(uint16_t batch_size, uint32_t flush_interval) {
+  this->batch_size_ = batch_size;
+  this->batch_flush_interval_ = flush_interval;
+}
+#endif
 
 void MQTTSensorComponent::send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) {
   // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks) false positive with ArduinoJson
@@ -87,6 +111,68 @@ bool MQTTSensorComponent::publish_state(float value) {
   return this->publish(this->get_state_topic_to_(topic_buf), buf, len);
 }
 
+#ifdef USE_MQTT_SENSOR_BATCH
+void MQTTSensorComponent::add_batch_sample_(float value) {
+  if (this->batch_count_ == 0)
+    this->schedule_batch_flush_();
+  if (this->batch_count_ == this->batch_size_) {
+    // Ring is full and could not be flushed, overwrite the oldest sample
+    this->batch_head_ = (this->batch_head_ + 1) % this->batch_size_;
+    this->batch_count_--;
+  }
+  uint16_t index = (this->batch_head_ + this->batch_count_) % this->batch_size_;
+  this->batch_[index] = {millis(), value};
+  this->batch_count_++;
+  if (this->batch_count_ == this->batch_size_ && this->flush_batch_())
+    this->cancel_timeout("batch");
+}
+
+void MQTTSensorComponent::schedule_batch_flush_() {
+  this->set_timeout("batch", this->batch_flush_interval_, [this]() {
+    // Not connected: keep buffering and retry after another interval
+    if (!this->flush_batch_())
+      this->schedule_batch_flush_();
+  });
+}
+
+bool MQTTSensorComponent::flush_batch_() {
+  if (this->batch_count_ == 0)
+    return true;
+  if (!global_mqtt_client->is_connected())
+    return false;
+  // Compact payload with timestamps relative to the oldest sample:
+  //   {"age":<ms since oldest sample>,"s":[[<offset ms>,<value>],...]}
+  // Receivers reconstruct sample times as (receive time - age + offset).
+  const BatchSample &oldest = this->batch_[this->batch_head_];
+  int8_t accuracy = this->sensor_->get_accuracy_decimals();
+  // Written into the buffer allocated next to the ring in setup(), which fits batch_size_ samples
+  char *payload = this->batch_payload_.get();
+  const size_t size = batch_payload_size(this->batch_size_);
+  char buf[VALUE_ACCURACY_MAX_LEN];
+  size_t pos = buf_append_printf(payload, size, 0, "{\"age\":%" PRIu32 ",\"s\":[", millis() - oldest.timestamp);
+  for (uint16_t i = 0; i < this->batch_count_; i++) {
+    const BatchSample &sample = this->batch_[(this->batch_head_ + i) % this->batch_size_];
+    pos = buf_append_printf(payload, size, pos, "%s[%" PRIu32 ",", i > 0 ? "," : "",
+                            sample.timestamp - oldest.timestamp);
+    if (std::isnan(sample.value)) {
+      pos = buf_append_printf(payload, size, pos, "null]");
+    } else {
+      size_t len = value_accuracy_to_buf(buf, sample.value, accuracy);
+      pos = buf_append_printf(payload, size, pos, "%.*s]", static_cast<int>(len), buf);
+    }
+  }
+  pos = buf_append_printf(payload, size, pos, "]}");
+  // Never retained: "age" is relative to now, a late subscriber would place the samples wrongly
+  if (!this->track_publish_(global_mqtt_client->publish(this->batch_topic_.c_str(), payload, pos, this->qos_, false)))
+    return false;
+  float latest = this->batch_[(this->batch_head_ + this->batch_count_ - 1) % this->batch_size_].value;
+  this->batch_head_ = 0;
+  this->batch_count_ = 0;
+  this->publish_state(latest);
+  return true;
+}
+#endif
+
 }  // namespace esphome::mqtt
 
 #endif
@@ -26,6 +26,18 @@ class MQTTSensorComponent final : public mqtt::MQTTComponent {
   /// Disable Home Assistant value expiry.
   void disable_expire_after();
 
+#ifdef USE_MQTT_SENSOR_BATCH
+  /** Buffer samples and publish them together on `<state topic>/batch`.
+   *
+   * A batch is flushed when batch_size samples are buffered or flush_interval ms after its first sample,
+   * whichever comes first. The latest value is also published to the regular state topic on every flush.
+   *
+   * @param batch_size Capacity of the sample ring, 0 disables batching.
+   * @param flush_interval Maximum age in milliseconds of a buffered sample before the batch is published.
+   */
+  void set_batch(uint16_t batch_size, uint32_t flush_interval);
+#endif
+
   void send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) override;
 
   // ========== INTERNAL METHODS ==========
@@ -40,14 +52,42 @@ class MQTTSensorComponent final : public mqtt::MQTTComponent {
 
   bool publish_state(float value);
   bool send_initial_state() override;
+#ifdef USE_MQTT_BURST
+  bool has_initial_state() const override { return this->sensor_->has_state(); }
+#endif
 
  protected:
   /// Override for MQTTComponent, returns "sensor".
   const char *component_type() const override;
   const EntityBase *get_entity() const override;
 
+#ifdef USE_MQTT_SENSOR_BATCH
+  /// Worst case batch payload length: header, one `,[<offset>,<value>]` per sample, footer and terminator.
+  static constexpr size_t batch_payload_size(uint16_t batch_size) {
+    return 26 + static_cast<size_t>(batch_size) * (VALUE_ACCURACY_MAX_LEN + 14);
+  }
+
+  struct BatchSample {
+    uint32_t timestamp;  ///< millis() when the sample was taken
+    float value;
+  };
+
+  void add_batch_sample_(float value);
+  void schedule_batch_flush_();
+  bool flush_batch_();
+#endif
+
   sensor::Sensor *sensor_;
   optional<uint32_t> expire_after_;  // Override the expire after advertised to Home Assistant
+#ifdef USE_MQTT_SENSOR_BATCH
+  std::unique_ptr<BatchSample[]> batch_;  ///< Fixed ring of batch_size_ samples, allocated in setup()
+  std::unique_ptr<char[]> batch_payload_;  ///< Flush buffer of batch_payload_size(batch_size_), allocated in setup()
+  std::string batch_topic_;
+  uint32_t batch_flush_interval_{0};
+  uint16_t batch_size_{0};
+  uint16_t batch_head_{0};   ///< Index of the oldest buffered sample
+  uint16_t batch_count_{0};  ///< Number of buffered samples
+#endif
 };
 
 }  // namespace esphome::mqtt
@@ -0,0 +1,73 @@
+#include "mqtt_tcp_probe.h"
+#if defined(USE_MQTT_FAILOVER) || defined(USE_MQTT_DUAL_STACK)
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "lwip/init.h"
+#include "lwip/tcp.h"
+
+namespace esphome::mqtt {
+
+void MQTTTcpProbe::start(const network::IPAddress &ip, uint16_t port) {
+  this->cancel();
+  this->ip_ = ip;
+  this->started_at_ = millis();
+  ip_addr_t addr = ip;
+  LwIPLock lock;
+#if LWIP_VERSION_MAJOR == 1
+  this->pcb_ = tcp_new();
+#else
+  this->pcb_ = tcp_new_ip_type(IP_GET_TYPE(&addr));
+#endif
+  if (this->pcb_ == nullptr) {
+    this->state_ = FAILED;
+    return;
+  }
+  this->state_ = PENDING;
+  tcp_arg(this->pcb_, this);
+  tcp_err(this->pcb_, MQTTTcpProbe::error_callback);
+  if (tcp_connect(this->pcb_, &addr, port, MQTTTcpProbe::connected_callback) != ERR_OK) {
+    tcp_abort(this->pcb_);
+    this->pcb_ = nullptr;
+    this->state_ = FAILED;
+  }
+}
+
+void MQTTTcpProbe::cancel() {
+  if (this->pcb_ != nullptr) {
+    LwIPLock lock;
+    // The pcb may have been freed by a callback that ran before the lock was taken
+    if (this->pcb_ != nullptr) {
+      tcp_arg(this->pcb_, nullptr);
+      tcp_err(this->pcb_, nullptr);
+      tcp_abort(this->pcb_);
+      this->pcb_ = nullptr;
+    }
+  }
+  this->state_ = IDLE;
+}
+
+err_t MQTTTcpProbe::connected_callback(void *arg, struct tcp_pcb *pcb, err_t err) {
+  auto *probe = static_cast<MQTTTcpProbe *>(arg);
+  // Reset instead of closing: no TIME_WAIT pcb is left behind and the broker sees no half-open client
+  tcp_arg(pcb, nullptr);
+  tcp_err(pcb, nullptr);
+  tcp_abort(pcb);
+  if (probe != nullptr) {
+    probe->pcb_ = nullptr;
+    probe->state_ = err == ERR_OK ? CONNECTED : FAILED;
+  }
+  return ERR_ABRT;
+}
+
+void MQTTTcpProbe::error_callback(void *arg, err_t err) {
+  // lwIP has already freed the pcb (refused, unreachable or timed out)
+  auto *probe = static_cast<MQTTTcpProbe *>(arg);
+  if (probe == nullptr)
+    return;
+  probe->pcb_ = nullptr;
+  probe->state_ = FAILED;
+}
+
+}  // namespace esphome::mqtt
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include "esphome/core/defines.h"
+#if defined(USE_MQTT_FAILOVER) || defined(USE_MQTT_DUAL_STACK)
+#include <cstdint>
+#include "esphome/components/network/ip_address.h"
+#include "lwip/err.h"
+
+struct tcp_pcb;
+
+namespace esphome::mqtt {
+
+/** TCP handshake to a broker next to the MQTT connection.
+ *
+ * Only checks that the broker accepts a TCP connection: the connection is reset as soon as the handshake
+ * completes, so nothing reaches the MQTT layer. Runs on lwIP's raw API and never blocks; poll state() from
+ * loop(). A probe that is neither answered nor refused stays PENDING, the caller decides when to give up.
+ */
+class MQTTTcpProbe {
+ public:
+  enum State : uint8_t {
+    IDLE,
+    PENDING,
+    CONNECTED,
+    FAILED,
+  };
+
+  /// Start a handshake with ip:port, cancelling any probe still pending.
+  void start(const network::IPAddress &ip, uint16_t port);
+  /// Abort a pending handshake and return to IDLE.
+  void cancel();
+
+  State state() const { return this->state_; }
+  const network::IPAddress &ip() const { return this->ip_; }
+  uint32_t started_at() const { return this->started_at_; }
+
+ protected:
+  static err_t connected_callback(void *arg, struct tcp_pcb *pcb, err_t err);
+  static void error_callback(void *arg, err_t err);
+
+  struct tcp_pcb *pcb_{nullptr};
+  network::IPAddress ip_;
+  uint32_t started_at_{0};
+  State state_{IDLE};  ///< Written from lwIP's callbacks, like the DNS result in MQTTClientComponent
+};
+
+}  // namespace esphome::mqtt
+#endif
@@ -23,6 +23,9 @@ class MQTTTextSensor final : public mqtt::MQTTComponent {
   bool publish_state(const std::string &value);
 
   bool send_initial_state() override;
+#ifdef USE_MQTT_BURST
+  bool has_initial_state() const override { return this->sensor_->has_state(); }
+#endif
 
  protected:
   const char *component_type() const override;
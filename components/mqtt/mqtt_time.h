@@ -27,6 +27,9 @@ class MQTTTimeComponent final : public mqtt::MQTTComponent {
   void send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) override;
 
   bool send_initial_state() override;
+#ifdef USE_MQTT_BURST
+  bool has_initial_state() const override { return this->time_->has_state(); }
+#endif
 
   bool publish_state(uint8_t hour, uint8_t minute, uint8_t second);
 
@@ -20,6 +20,10 @@ class MQTTValveComponent final : public mqtt::MQTTComponent {
   MQTT_COMPONENT_CUSTOM_TOPIC(position, command)
   MQTT_COMPONENT_CUSTOM_TOPIC(position, state)
 
+#ifdef USE_MQTT_VALVE_JSON
+  void set_use_json_format(bool use_json_format) { this->use_json_format_ = use_json_format; }
+#endif
+
   bool send_initial_state() override;
 
   bool publish_state();
@@ -31,6 +35,9 @@ class MQTTValveComponent final : public mqtt::MQTTComponent {
   const EntityBase *get_entity() const override;
 
   valve::Valve *valve_;
+#ifdef USE_MQTT_VALVE_JSON
+  bool use_json_format_{false};
+#endif
 };
 
 }  // namespace esphome::mqtt
@@ -0,0 +1,132 @@
+import esphome.codegen as cg
+from esphome.components import sensor
+import esphome.config_validation as cv
+from esphome.const import (
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MILLISECOND,
+    UNIT_SECOND,
+)
+
+from . import MQTTClientComponent
+
+DEPENDENCIES = ["mqtt"]
+
+CONF_MQTT_CLIENT_ID = "mqtt_client_id"
+CONF_SYNC_DURATION = "sync_duration"
+CONF_RECONNECT_BACKOFF = "reconnect_backoff"
+CONF_CONNECT_DURATION = "connect_duration"
+CONF_DNS_TIME = "dns_time"
+CONF_RECONNECTS = "reconnects"
+CONF_DISCONNECTS = "disconnects"
+CONF_CONNECTED_TIME = "connected_time"
+CONF_LATENCY_P50 = "latency_p50"
+CONF_LATENCY_P95 = "latency_p95"
+CONF_LATENCY_MAX = "latency_max"
+
+# Sensors backed by the client's connection telemetry, configuring one turns it on
+TELEMETRY_SENSORS = {
+    CONF_DNS_TIME: "set_dns_time_sensor",
+    CONF_RECONNECTS: "set_reconnects_sensor",
+    CONF_DISCONNECTS: "set_disconnects_sensor",
+    CONF_CONNECTED_TIME: "set_connected_time_sensor",
+}
+
+# Sensors backed by the broker round trip probe, configuring one turns it on with its defaults
+LATENCY_SENSORS = {
+    CONF_LATENCY_P50: "set_latency_p50_sensor",
+    CONF_LATENCY_P95: "set_latency_p95_sensor",
+    CONF_LATENCY_MAX: "set_latency_max_sensor",
+}
+
+LATENCY_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    accuracy_decimals=0,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_MQTT_CLIENT_ID): cv.use_id(MQTTClientComponent),
+        cv.Optional(CONF_SYNC_DURATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_CONNECT_DURATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_DNS_TIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_RECONNECTS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_DISCONNECTS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_CONNECTED_TIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_SECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_LATENCY_P50): LATENCY_SENSOR_SCHEMA,
+        cv.Optional(CONF_LATENCY_P95): LATENCY_SENSOR_SCHEMA,
+        cv.Optional(CONF_LATENCY_MAX): LATENCY_SENSOR_SCHEMA,
+        cv.Optional(CONF_RECONNECT_BACKOFF): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
+
+async def to_code(config):
+    client = await cg.get_variable(config[CONF_MQTT_CLIENT_ID])
+
+    if sync_duration_config := config.get(CONF_SYNC_DURATION):
+        sens = await sensor.new_sensor(sync_duration_config)
+        cg.add(client.set_sync_duration_sensor(sens))
+
+    if reconnect_backoff_config := config.get(CONF_RECONNECT_BACKOFF):
+        sens = await sensor.new_sensor(reconnect_backoff_config)
+        cg.add(client.set_reconnect_backoff_sensor(sens))
+
+    if connect_duration_config := config.get(CONF_CONNECT_DURATION):
+        sens = await sensor.new_sensor(connect_duration_config)
+        cg.add(client.set_connect_duration_sensor(sens))
+
+    for key, setter in TELEMETRY_SENSORS.items():
+        if sensor_config := config.get(key):
+            cg.add_define("USE_MQTT_TELEMETRY")
+            sens = await sensor.new_sensor(sensor_config)
+            cg.add(getattr(client, setter)(sens))
+
+    for key, setter in LATENCY_SENSORS.items():
+        if sensor_config := config.get(key):
+            cg.add_define("USE_MQTT_LATENCY_PROBE")
+            sens = await sensor.new_sensor(sensor_config)
+            cg.add(getattr(client, setter)(sens))
@@ -0,0 +1,256 @@
+// Host test for MQTTAddressRace, the staggered IPv6/IPv4 connect of the broker (family_fallback_timeout).
+//
+// The race is driven the way MQTTClientComponent::check_address_race_() drives it, with non-blocking POSIX
+// connects standing in for MQTTTcpProbe. A family is "blackholed" by connecting to a loopback listener whose
+// accept queue is full: Linux then drops the SYN, so the handshake is neither answered nor refused.
+#include "mqtt_address_race.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using esphome::mqtt::MQTTAddressRace;
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(cond) \
+  do { \
+    if (!(cond)) { \
+      std::fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+uint32_t now_ms() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+enum class Endpoint { LISTENING, BLACKHOLED, REFUSED, UNRESOLVED };
+
+/// A loopback endpoint of one family that accepts, drops or refuses handshakes.
+struct TestBroker {
+  int family;
+  Endpoint endpoint;
+  int listener{-1};
+  std::vector<int> fillers;
+  sockaddr_storage addr{};
+  socklen_t addr_len{0};
+
+  TestBroker(int family, Endpoint endpoint) : family(family), endpoint(endpoint) {
+    if (endpoint == Endpoint::UNRESOLVED)
+      return;
+    if (family == AF_INET6) {
+      auto *in6 = reinterpret_cast<sockaddr_in6 *>(&this->addr);
+      in6->sin6_family = AF_INET6;
+      in6->sin6_addr = in6addr_loopback;
+      this->addr_len = sizeof(sockaddr_in6);
+    } else {
+      auto *in = reinterpret_cast<sockaddr_in *>(&this->addr);
+      in->sin_family = AF_INET;
+      in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      this->addr_len = sizeof(sockaddr_in);
+    }
+    this->listener = socket(family, SOCK_STREAM, 0);
+    bind(this->listener, reinterpret_cast<sockaddr *>(&this->addr), this->addr_len);
+    getsockname(this->listener, reinterpret_cast<sockaddr *>(&this->addr), &this->addr_len);
+    if (endpoint == Endpoint::REFUSED) {
+      // Bound but not listening: the port answers with RST
+      return;
+    }
+    listen(this->listener, endpoint == Endpoint::BLACKHOLED ? 0 : 8);
+    if (endpoint == Endpoint::BLACKHOLED) {
+      for (int i = 0; i < 3; i++) {
+        int filler = socket(family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        connect(filler, reinterpret_cast<sockaddr *>(&this->addr), this->addr_len);
+        this->fillers.push_back(filler);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  }
+  ~TestBroker() {
+    for (int filler : this->fillers)
+      close(filler);
+    if (this->listener >= 0)
+      close(this->listener);
+  }
+};
+
+/// Non-blocking handshake, the host counterpart of MQTTTcpProbe.
+struct Probe {
+  int fd{-1};
+  bool started{false};
+
+  void start(const TestBroker &broker) {
+    this->fd = socket(broker.family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    this->started = true;
+    connect(this->fd, reinterpret_cast<const sockaddr *>(&broker.addr), broker.addr_len);
+  }
+  /// 1 connected, -1 failed, 0 pending.
+  int result() const {
+    if (!this->started)
+      return 0;
+    pollfd pfd{this->fd, POLLOUT, 0};
+    if (poll(&pfd, 1, 0) <= 0)
+      return 0;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(this->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    return err == 0 ? 1 : -1;
+  }
+  ~Probe() {
+    if (this->fd >= 0)
+      close(this->fd);
+  }
+};
+
+struct RaceResult {
+  MQTTAddressRace::Action outcome{MQTTAddressRace::ACTION_NONE};
+  MQTTAddressRace::Family winner{MQTTAddressRace::FAMILY_IPV6};
+  uint32_t elapsed{0};
+  bool probed[2]{false, false};
+};
+
+RaceResult run_race(Endpoint ipv6, Endpoint ipv4, bool ipv6_first, uint32_t stagger, uint32_t timeout = 5000) {
+  TestBroker brokers[2] = {TestBroker(AF_INET6, ipv6), TestBroker(AF_INET, ipv4)};
+  Probe probes[2];
+  bool reported[2] = {false, false};
+  MQTTAddressRace race;
+  RaceResult result;
+  const uint32_t start = now_ms();
+  race.start(start, ipv6_first, stagger);
+  for (int family = 0; family < 2; family++)
+    race.resolved(static_cast<MQTTAddressRace::Family>(family), brokers[family].endpoint != Endpoint::UNRESOLVED);
+
+  while (now_ms() - start < timeout) {
+    for (int family = 0; family < 2; family++) {
+      const int probe = probes[family].result();
+      if (probe != 0 && !reported[family]) {
+        reported[family] = true;
+        race.probed(static_cast<MQTTAddressRace::Family>(family), probe > 0);
+      }
+    }
+    for (;;) {
+      const MQTTAddressRace::Action action = race.poll(now_ms());
+      if (action == MQTTAddressRace::ACTION_PROBE_IPV6 || action == MQTTAddressRace::ACTION_PROBE_IPV4) {
+        const int family = action == MQTTAddressRace::ACTION_PROBE_IPV6 ? 0 : 1;
+        result.probed[family] = true;
+        probes[family].start(brokers[family]);
+        continue;
+      }
+      if (action == MQTTAddressRace::ACTION_CONNECT || action == MQTTAddressRace::ACTION_FAILED) {
+        result.outcome = action;
+        result.winner = race.winner();
+        result.elapsed = now_ms() - start;
+        return result;
+      }
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  result.elapsed = now_ms() - start;
+  return result;
+}
+
+void test_blackholed_ipv6_falls_back_after_stagger() {
+  // The case the option exists for: IPv6 is preferred but its path silently drops packets
+  const uint32_t stagger = 300;
+  RaceResult result = run_race(Endpoint::BLACKHOLED, Endpoint::LISTENING, true, stagger);
+  EXPECT(result.outcome == MQTTAddressRace::ACTION_CONNECT);
+  EXPECT(result.winner == MQTTAddressRace::FAMILY_IPV4);
+  EXPECT(result.probed[0] && result.probed[1]);
+  // Connected one stagger after the start, not after a connect timeout
+  EXPECT(result.elapsed >= stagger);
+  EXPECT(result.elapsed < stagger + 200);
+  std::printf("blackholed IPv6: IPv4 connected after %ums (stagger %ums)\n", result.elapsed, stagger);
+}
+
+void test_working_preferred_family_wins_without_waiting() {
+  RaceResult result = run_race(Endpoint::LISTENING, Endpoint::LISTENING, true, 300);
+  EXPECT(result.outcome == MQTTAddressRace::ACTION_CONNECT);
+  EXPECT(result.winner == MQTTAddressRace::FAMILY_IPV6);
+  EXPECT(!result.probed[1]);
+  EXPECT(result.elapsed < 300);
+}
+
+void test_preference_follows_last_family() {
+  RaceResult result = run_race(Endpoint::LISTENING, Endpoint::LISTENING, false, 300);
+  EXPECT(result.outcome == MQTTAddressRace::ACTION_CONNECT);
+  EXPECT(result.winner == MQTTAddressRace::FAMILY_IPV4);
+  EXPECT(!result.probed[0]);
+}
+
+void test_refused_preferred_family_skips_stagger() {
+  RaceResult result = run_race(Endpoint::REFUSED, Endpoint::LISTENING, true, 1000);
+  EXPECT(result.outcome == MQTTAddressRace::ACTION_CONNECT);
+  EXPECT(result.winner == MQTTAddressRace::FAMILY_IPV4);
+  EXPECT(result.elapsed < 1000);
+}
+
+void test_unresolved_preferred_family_skips_stagger() {
+  RaceResult result = run_race(Endpoint::UNRESOLVED, Endpoint::LISTENING, true, 1000);
+  EXPECT(result.outcome == MQTTAddressRace::ACTION_CONNECT);
+  EXPECT(result.winner == MQTTAddressRace::FAMILY_IPV4);
+  EXPECT(!result.probed[0]);
+  EXPECT(result.elapsed < 1000);
+}
+
+void test_both_refused_fails() {
+  RaceResult result = run_race(Endpoint::REFUSED, Endpoint::REFUSED, true, 100);
+  EXPECT(result.outcome == MQTTAddressRace::ACTION_FAILED);
+}
+
+void test_both_unresolved_fails_without_probing() {
+  MQTTAddressRace race;
+  race.start(0, true, 100);
+  race.resolved(MQTTAddressRace::FAMILY_IPV6, false);
+  EXPECT(race.poll(0) == MQTTAddressRace::ACTION_NONE);
+  race.resolved(MQTTAddressRace::FAMILY_IPV4, false);
+  EXPECT(!race.any_resolved());
+  EXPECT(race.poll(0) == MQTTAddressRace::ACTION_FAILED);
+  EXPECT(race.poll(0) == MQTTAddressRace::ACTION_NONE);
+}
+
+void test_other_family_waits_for_stagger() {
+  MQTTAddressRace race;
+  race.start(1000, true, 250);
+  // Only the fallback family resolved so far
+  race.resolved(MQTTAddressRace::FAMILY_IPV4, true);
+  EXPECT(race.poll(1100) == MQTTAddressRace::ACTION_NONE);
+  EXPECT(race.poll(1250) == MQTTAddressRace::ACTION_PROBE_IPV4);
+  // The preferred family may still join the race when its lookup completes late
+  race.resolved(MQTTAddressRace::FAMILY_IPV6, true);
+  EXPECT(race.poll(1300) == MQTTAddressRace::ACTION_PROBE_IPV6);
+  race.probed(MQTTAddressRace::FAMILY_IPV6, true);
+  EXPECT(race.poll(1310) == MQTTAddressRace::ACTION_CONNECT);
+  EXPECT(race.winner() == MQTTAddressRace::FAMILY_IPV6);
+}
+
+}  // namespace
+
+int main() {
+  test_blackholed_ipv6_falls_back_after_stagger();
+  test_working_preferred_family_wins_without_waiting();
+  test_preference_follows_last_family();
+  test_refused_preferred_family_skips_stagger();
+  test_unresolved_preferred_family_skips_stagger();
+  test_both_refused_fails();
+  test_both_unresolved_fails_without_probing();
+  test_other_family_waits_for_stagger();
+  if (failures != 0) {
+    std::fprintf(stderr, "%d expectation(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("address_race_test: OK\n");
+  return EXIT_SUCCESS;
+}
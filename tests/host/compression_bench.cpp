@@ -0,0 +1,84 @@
+// Host benchmark for heatshrink_compress(), the encoder publish() runs inline for compressed topics: compression
+// ratio against CPU time per window/lookahead setting.
+//
+// The encoder is a brute-force match search: every input byte scans the whole window, so its cost grows with
+// window size times payload size. The cases below bound it: a typical JSON payload, and a worst case where every
+// window position has to be checked (incompressible data). Device timing scales roughly with clock speed and
+// memory latency. An ESP8266 at 80 MHz is about 50-100 times slower than a desktop core. An RP2040 at 133 MHz
+// (Cortex-M0+, code in flash behind the XIP cache) is about 30-60 times slower.
+//   make -C tests/host bench
+#include "mqtt_compression.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using esphome::mqtt::heatshrink_compress;
+
+namespace {
+
+std::string json_payload(size_t size) {
+  std::string out = "{";
+  for (unsigned i = 0; out.size() < size; i++) {
+    char entry[96];
+    std::snprintf(entry, sizeof(entry), "\"sensor_%u\":{\"value\":%u.%u,\"unit\":\"kWh\",\"state_class\":\"total\"},",
+                  i, i * 37 % 1000, i % 10);
+    out += entry;
+  }
+  out.resize(size - 1);
+  out += "}";
+  return out;
+}
+
+std::string worst_case_payload(size_t size) {
+  // Incompressible bytes: no match ever reaches the lookahead, so every byte scans the whole window
+  std::string out;
+  uint32_t state = 1;
+  while (out.size() < size) {
+    state = state * 1103515245u + 12345u;
+    out += static_cast<char>(state >> 24);
+  }
+  return out;
+}
+
+struct BenchResult {
+  double microseconds;  ///< Per call
+  double ratio;         ///< Compressed size over payload size, above 1 means publish() sends the plain payload
+};
+
+BenchResult run_bench(const std::string &payload, uint8_t window_bits, uint8_t lookahead_bits) {
+  // Room for the worst case, 9 bits per literal, so incompressible data still reports its size
+  std::vector<uint8_t> out(payload.size() * 9 / 8 + 1);
+  const auto *in = reinterpret_cast<const uint8_t *>(payload.data());
+  size_t compressed = 0;
+  unsigned iterations = 0;
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::micro> elapsed{};
+  do {
+    compressed = heatshrink_compress(in, payload.size(), out.data(), out.size(), window_bits, lookahead_bits);
+    iterations++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed.count() < 200000);
+  return {elapsed.count() / iterations, static_cast<double>(compressed) / payload.size()};
+}
+
+}  // namespace
+
+int main() {
+  // Up to the limits of the compression options: window_bits 8, max_size 2048
+  const size_t sizes[] = {256, 1024, 2048};
+  const uint8_t windows[][2] = {{4, 3}, {6, 4}, {8, 4}, {8, 7}};
+  std::printf("%-6s %-9s %-7s %11s %11s %11s %11s\n", "window", "lookahead", "bytes", "json us", "json ratio",
+              "worst us", "worst ratio");
+  for (const auto &window : windows) {
+    for (size_t size : sizes) {
+      const BenchResult json = run_bench(json_payload(size), window[0], window[1]);
+      const BenchResult worst = run_bench(worst_case_payload(size), window[0], window[1]);
+      std::printf("%-6u %-9u %-7zu %11.1f %11.2f %11.1f %11.2f\n", window[0], window[1], size, json.microseconds,
+                  json.ratio, worst.microseconds, worst.ratio);
+    }
+  }
+  std::printf("Host times; on a device multiply by about 50-100 (ESP8266 at 80 MHz) or 30-60 (RP2040 at 133 MHz)\n");
+  return 0;
+}
@@ -0,0 +1,105 @@
+// Host test for heatshrink_compress(): decoding its output with a reference heatshrink decoder gives back the input.
+#include "mqtt_compression.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using esphome::mqtt::heatshrink_compress;
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(cond) \
+  do { \
+    if (!(cond)) { \
+      std::fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+/// Decoder for the bitstream documented in mqtt_compression.h.
+std::string heatshrink_decompress(const std::vector<uint8_t> &in, uint8_t window_bits, uint8_t lookahead_bits) {
+  size_t bit = 0;
+  const size_t total = in.size() * 8;
+  auto read = [&](uint8_t count, uint16_t &value) {
+    if (bit + count > total)
+      return false;
+    value = 0;
+    for (uint8_t i = 0; i < count; i++, bit++)
+      value = (value << 1) | ((in[bit / 8] >> (7 - bit % 8)) & 1);
+    return true;
+  };
+  std::string out;
+  uint16_t tag, value, length;
+  while (read(1, tag)) {
+    if (tag == 1) {
+      if (!read(8, value))
+        break;
+      out += static_cast<char>(value);
+    } else {
+      // Zero padding of the last byte reads as the start of a back-reference that does not fit
+      if (!read(window_bits, value) || !read(lookahead_bits, length))
+        break;
+      const size_t from = out.size() - (value + 1);
+      for (size_t i = 0; i <= length; i++)
+        out += out[from + i];
+    }
+  }
+  return out;
+}
+
+void expect_round_trip(const std::string &payload, uint8_t window_bits, uint8_t lookahead_bits) {
+  std::vector<uint8_t> out(payload.size());
+  const size_t len = heatshrink_compress(reinterpret_cast<const uint8_t *>(payload.data()), payload.size(),
+                                         out.data(), out.size(), window_bits, lookahead_bits);
+  EXPECT(len > 0);
+  EXPECT(len < payload.size());
+  out.resize(len);
+  EXPECT(heatshrink_decompress(out, window_bits, lookahead_bits) == payload);
+}
+
+void test_json_round_trip() {
+  std::string payload = "{";
+  for (unsigned i = 0; i < 40; i++)
+    payload += "\"sensor_" + std::to_string(i) + "\":{\"value\":" + std::to_string(i * 7) + ",\"unit\":\"kWh\"},";
+  payload.back() = '}';
+  expect_round_trip(payload, 4, 3);
+  expect_round_trip(payload, 6, 4);
+  expect_round_trip(payload, 8, 4);
+  expect_round_trip(payload, 8, 7);
+}
+
+void test_runs_round_trip() {
+  // Matches that overlap the position being encoded
+  expect_round_trip(std::string(500, 'a'), 8, 4);
+  expect_round_trip(std::string(300, 'x') + "y" + std::string(300, 'x'), 6, 5);
+}
+
+void test_incompressible_gives_up() {
+  std::string payload;
+  uint32_t state = 1;
+  while (payload.size() < 512) {
+    state = state * 1103515245u + 12345u;
+    payload += static_cast<char>(state >> 24);
+  }
+  std::vector<uint8_t> out(payload.size() - 1);
+  EXPECT(heatshrink_compress(reinterpret_cast<const uint8_t *>(payload.data()), payload.size(), out.data(),
+                             out.size(), 8, 4) == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_json_round_trip();
+  test_runs_round_trip();
+  test_incompressible_gives_up();
+  if (failures != 0) {
+    std::fprintf(stderr, "%d expectation(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("compression_test: OK\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,4 @@
+#pragma once
+// Features whose code the host tests build, see tests/host/Makefile
+#define USE_MQTT_COMPRESSION
+#define USE_MQTT_DUAL_STACK